@@ -0,0 +1,167 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Bitset.h"
+
+Bitset::Bitset(unsigned int newBitCount)
+{
+	bitCount = 0;
+	resize(newBitCount);
+}
+
+Bitset::~Bitset()
+{
+	clear();
+}
+
+unsigned int Bitset::size() const
+{
+	return bitCount;
+}
+
+/*!
+ * @brief empty
+ * @return true if no bit is set
+ */
+bool Bitset::empty() const
+{
+	for (unsigned int i = 0; i < words.size(); ++i)
+	{
+		if (words[i])
+			return false;
+	}
+
+	return true;
+}
+
+bool Bitset::test(unsigned int index) const
+{
+	if (index >= bitCount)
+		return false;
+
+	return (words[index / WORD_BITS] >> (index % WORD_BITS)) & 1UL;
+}
+
+/*!
+ * @brief count
+ * @return the number of set bits
+ */
+unsigned int Bitset::count() const
+{
+	unsigned int total = 0;
+	for (unsigned int i = 0; i < words.size(); ++i)
+		total += __builtin_popcountl(words[i]);
+
+	return total;
+}
+
+/*!
+ * @brief find the next set bit
+ * @details skips clear words whole, so walking a sparse selection is cheap
+ * @param index the first index to look at
+ * @return the index of the first set bit at or after index, or NPOS
+ */
+unsigned int Bitset::findNext(unsigned int index) const
+{
+	if (index >= bitCount)
+		return NPOS;
+
+	unsigned int wordIndex = index / WORD_BITS;
+	unsigned long word = words[wordIndex] & (~0UL << (index % WORD_BITS));
+	while (!word)
+	{
+		++wordIndex;
+		if (wordIndex >= words.size())
+			return NPOS;
+
+		word = words[wordIndex];
+	}
+
+	return (wordIndex * WORD_BITS) + __builtin_ctzl(word);
+}
+
+bool Bitset::operator==(const Bitset& other) const
+{
+	return (bitCount == other.bitCount) && (words == other.words);
+}
+
+bool Bitset::operator!=(const Bitset& other) const
+{
+	return !(*this == other);
+}
+
+/*!
+ * @brief resize
+ * @details new bits start clear
+ * @param newBitCount the number of bits
+ */
+void Bitset::resize(unsigned int newBitCount)
+{
+	words.resize((newBitCount + WORD_BITS - 1) / WORD_BITS, 0UL);
+	bitCount = newBitCount;
+
+	// keep the bits past the end clear
+	if ((bitCount % WORD_BITS) && (!words.empty()))
+		words.back() &= (1UL << (bitCount % WORD_BITS)) - 1UL;
+}
+
+/*!
+ * @brief set a bit
+ * @details grows the set to hold the index
+ * @param index the index
+ * @param value the new bit
+ */
+void Bitset::set(unsigned int index, bool value)
+{
+	if (index >= bitCount)
+	{
+		if (!value)
+			return;
+
+		resize(index + 1);
+	}
+
+	if (value)
+		words[index / WORD_BITS] |= (1UL << (index % WORD_BITS));
+	else
+		words[index / WORD_BITS] &= ~(1UL << (index % WORD_BITS));
+}
+
+void Bitset::reset(unsigned int index)
+{
+	set(index, false);
+}
+
+void Bitset::flip(unsigned int index)
+{
+	set(index, !test(index));
+}
+
+void Bitset::setAll(bool value)
+{
+	for (unsigned int i = 0; i < words.size(); ++i)
+		words[i] = value ? ~0UL : 0UL;
+
+	// keep the bits past the end clear
+	if ((bitCount % WORD_BITS) && (!words.empty()))
+		words.back() &= (1UL << (bitCount % WORD_BITS)) - 1UL;
+}
+
+void Bitset::clear()
+{
+	words.clear();
+	bitCount = 0;
+}
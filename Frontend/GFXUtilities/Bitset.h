@@ -0,0 +1,63 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GBITSET
+#define _GBITSET
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief Bitset
+ * @details Growable set of indices packed one bit per index. Used to share a selection between
+ * components, e.g. the points brushed on a graph and the rows of a table over the same data.
+ */
+
+class Bitset
+{
+private:
+	std::vector<unsigned long> words;
+	unsigned int bitCount;
+
+	static const unsigned int WORD_BITS = sizeof(unsigned long) * 8;
+
+public:
+	static const unsigned int NPOS = 0xFFFFFFFF;
+
+	// constructors & destructor
+	Bitset(unsigned int = 0);
+	~Bitset();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	bool test(unsigned int) const;
+	unsigned int count() const;
+	unsigned int findNext(unsigned int) const;
+	bool operator==(const Bitset&) const;
+	bool operator!=(const Bitset&) const;
+
+	// sets
+	void resize(unsigned int);
+	void set(unsigned int, bool = true);
+	void reset(unsigned int);
+	void flip(unsigned int);
+	void setAll(bool = true);
+	void clear();
+};
+
+#endif
@@ -0,0 +1,296 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Colormap.h"
+#include <math.h>
+
+// evenly spaced anchors, interpolated into the table
+static const unsigned int ANCHOR_COUNT = 9;
+
+static const unsigned char VIRIDIS_ANCHORS[ANCHOR_COUNT][3] = {
+	{68, 1, 84},	{72, 40, 120},  {62, 73, 137},  {49, 104, 142}, {38, 130, 142},
+	{31, 158, 137}, {53, 183, 121}, {110, 206, 88}, {253, 231, 37}};
+
+static const unsigned char MAGMA_ANCHORS[ANCHOR_COUNT][3] = {
+	{0, 0, 4},		{28, 16, 68},	{79, 18, 123},   {129, 37, 129}, {181, 54, 122},
+	{229, 80, 100}, {251, 135, 97}, {254, 194, 135}, {252, 253, 191}};
+
+static unsigned char toByte(float value)
+{
+	if (value <= 0.0f)
+		return 0;
+	if (value >= 1.0f)
+		return 0xFF;
+
+	return (unsigned char)((value * 255.0f) + 0.5f);
+}
+
+Colormap::Colormap(int newType, unsigned int newSize)
+{
+	type = newType;
+	tableScale = 0.0f;
+	buildTable(newSize);
+}
+
+Colormap::~Colormap()
+{
+	table.clear();
+	tableScale = 0.0f;
+}
+
+int Colormap::getType() const
+{
+	return type;
+}
+
+unsigned int Colormap::size() const
+{
+	return table.size();
+}
+
+unsigned int Colormap::pack(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+	return (((unsigned int)r) << 24) | (((unsigned int)g) << 16) | (((unsigned int)b) << 8) | a;
+}
+
+/*!
+ * @brief get a color
+ * @param t the position in the map, clamped to [0, 1]
+ * @return the packed RGBA8888 color
+ */
+unsigned int Colormap::getColor(float t) const
+{
+	if (!(t > 0.0f))
+		return table[0];
+
+	unsigned int index = (unsigned int)(t * tableScale);
+	if (index >= table.size())
+		index = table.size() - 1;
+
+	return table[index];
+}
+
+void Colormap::setType(int newType, unsigned int newSize)
+{
+	type = newType;
+	buildTable(newSize);
+}
+
+void Colormap::interpolate(const unsigned char (*anchors)[3], unsigned int tableSize)
+{
+	for (unsigned int i = 0; i < tableSize; ++i)
+	{
+		float pos = (((float)i) / ((float)(tableSize - 1))) * (ANCHOR_COUNT - 1);
+		unsigned int low = (unsigned int)pos;
+		if (low >= ANCHOR_COUNT - 1)
+			low = ANCHOR_COUNT - 2;
+		float frac = pos - low;
+
+		unsigned char rgb[3];
+		for (unsigned int c = 0; c < 3; ++c)
+		{
+			float value = anchors[low][c] + ((anchors[low + 1][c] - anchors[low][c]) * frac);
+			rgb[c] = (unsigned char)(value + 0.5f);
+		}
+
+		table[i] = pack(rgb[0], rgb[1], rgb[2]);
+	}
+}
+
+/*!
+ * @brief build the table
+ * @details fills the lookup table for the current type
+ * @param tableSize the number of entries, at least 2
+ */
+void Colormap::buildTable(unsigned int tableSize)
+{
+	if (tableSize < 2)
+		tableSize = 2;
+
+	table.resize(tableSize);
+	tableScale = (float)(tableSize - 1);
+
+	if (type == VIRIDIS)
+		interpolate(VIRIDIS_ANCHORS, tableSize);
+	else if (type == MAGMA)
+		interpolate(MAGMA_ANCHORS, tableSize);
+	else if (type == TURBO)
+	{
+		// polynomial fit of turbo
+		for (unsigned int i = 0; i < tableSize; ++i)
+		{
+			float t = ((float)i) / tableScale;
+			float r = 0.13572138f +
+					  t * (4.61539260f +
+						   t * (-42.66032258f +
+								t * (132.13108234f + t * (-152.94239396f + t * 59.28637943f))));
+			float g = 0.09140261f +
+					  t * (2.19418839f +
+						   t * (4.84296658f +
+								t * (-14.18503333f + t * (4.27729857f + t * 2.82956604f))));
+			float b = 0.10667330f +
+					  t * (12.64194608f +
+						   t * (-60.58204836f +
+								t * (110.36276771f + t * (-89.90310912f + t * 27.34824973f))));
+			table[i] = pack(toByte(r), toByte(g), toByte(b));
+		}
+	}
+	else if (type == HUE)
+	{
+		// the hue wheel of Graphics::RGBfromHue, hot at the top
+		for (unsigned int i = 0; i < tableSize; ++i)
+		{
+			double hue = 1.0f - (((double)i) / ((double)tableSize));
+			int h = int(hue * 256 * 6);
+			unsigned char x = h % 0x100;
+
+			unsigned char r = 0, g = 0, b = 0;
+			switch (h / 256)
+			{
+			case 0:
+				r = 0xFF;
+				g = x;
+				break;
+			case 1:
+				g = 0xFF;
+				r = 0xFF - x;
+				break;
+			case 2:
+				g = 0xFF;
+				b = x;
+				break;
+			case 3:
+				b = 0xFF;
+				g = 0xFF - x;
+				break;
+			case 4:
+				b = 0xFF;
+				r = x;
+				break;
+			case 5:
+				r = 0xFF;
+				b = 0xFF - x;
+				break;
+			}
+
+			table[i] = pack(r, g, b);
+		}
+	}
+	else
+	{
+		// GRAYSCALE
+		for (unsigned int i = 0; i < tableSize; ++i)
+		{
+			unsigned char level = toByte(((float)i) / tableScale);
+			table[i] = pack(level, level, level);
+		}
+	}
+}
+
+/*!
+ * @brief map
+ * @details colors n values through the table
+ * @param values the values
+ * @param count the number of values
+ * @param outRGBA the packed RGBA8888 colors, count entries
+ * @param minValue the value at the bottom of the map
+ * @param maxValue the value at the top of the map
+ */
+void Colormap::map(const float* values, unsigned int count, unsigned int* outRGBA,
+				   float minValue, float maxValue) const
+{
+	if ((!values) || (!outRGBA) || (count == 0))
+		return;
+
+	const float span = maxValue - minValue;
+	const float scale = (span > 0.0f) ? tableScale / span : 0.0f;
+	const float top = tableScale;
+	const unsigned int* lut = &table[0];
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float index = (values[i] - minValue) * scale;
+		if (!(index > 0.0f))
+			index = 0.0f;
+		else if (index > top)
+			index = top;
+
+		outRGBA[i] = lut[(unsigned int)index];
+	}
+}
+
+/*!
+ * @brief map counts
+ * @details colors n hit counts, 0 stays transparent and maxCount gets the top color
+ * @param counts the counts
+ * @param count the number of counts
+ * @param outRGBA the packed RGBA8888 colors, count entries
+ * @param maxCount the highest count
+ * @param logScale spread the counts on a log scale instead of a linear one
+ */
+void Colormap::mapCounts(const unsigned int* counts, unsigned int count, unsigned int* outRGBA,
+						 unsigned int maxCount, bool logScale) const
+{
+	if ((!counts) || (!outRGBA) || (count == 0))
+		return;
+
+	const unsigned int* lut = &table[0];
+	if (maxCount == 0)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			outRGBA[i] = 0;
+		return;
+	}
+
+	if (logScale)
+	{
+		const float scale = tableScale / logf(1.0f + (float)maxCount);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			unsigned int cCount = counts[i];
+			if (cCount == 0)
+			{
+				outRGBA[i] = 0;
+				continue;
+			}
+
+			unsigned int index = (unsigned int)(logf(1.0f + (float)cCount) * scale);
+			if (index >= table.size())
+				index = table.size() - 1;
+			outRGBA[i] = lut[index];
+		}
+		return;
+	}
+
+	// 16.16 fixed point, rounded up so maxCount lands on the top entry
+	const unsigned int top = table.size() - 1;
+	const unsigned int scale =
+		(unsigned int)((((unsigned long)top << 16) + maxCount - 1) / maxCount);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int cCount = counts[i];
+		if (cCount > maxCount)
+			cCount = maxCount;
+
+		unsigned int index = (unsigned int)(((unsigned long)cCount * scale) >> 16);
+		if (index > top)
+			index = top;
+
+		// no branch, 0 is masked to transparent
+		unsigned int mask = 0u - (unsigned int)(cCount != 0);
+		outRGBA[i] = lut[index] & mask;
+	}
+}
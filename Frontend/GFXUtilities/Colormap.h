@@ -0,0 +1,69 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GCOLORMAP
+#define _GCOLORMAP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief Colormap
+ * @details Precomputed lookup table from [0, 1] to packed RGBA8888 colors, the layout of
+ * SDL_PIXELFORMAT_RGBA8888. Coloring a buffer is one multiply and one table read per value.
+ */
+
+class Colormap
+{
+private:
+	int type;
+	std::vector<unsigned int> table;
+	float tableScale;
+
+	void buildTable(unsigned int);
+	void interpolate(const unsigned char (*)[3], unsigned int);
+
+public:
+	static const int VIRIDIS = 0;
+	static const int MAGMA = 1;
+	static const int TURBO = 2;
+	static const int GRAYSCALE = 3;
+	static const int HUE = 4;
+
+	static const unsigned int DEFAULT_SIZE = 256;
+	static const unsigned int LARGE_SIZE = 4096;
+
+	// constructors & destructor
+	Colormap(int = VIRIDIS, unsigned int = DEFAULT_SIZE);
+	~Colormap();
+
+	// gets
+	int getType() const;
+	unsigned int size() const;
+	unsigned int getColor(float) const;
+	static unsigned int pack(unsigned char, unsigned char, unsigned char, unsigned char = 0xFF);
+
+	// sets
+	void setType(int, unsigned int = DEFAULT_SIZE);
+
+	// kernels
+	void map(const float*, unsigned int, unsigned int*, float = 0.0f, float = 1.0f) const;
+	void mapCounts(const unsigned int*, unsigned int, unsigned int*, unsigned int,
+				   bool = false) const;
+};
+
+#endif
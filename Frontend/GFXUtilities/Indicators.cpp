@@ -0,0 +1,809 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Indicators.h"
+#include <math.h>
+
+/*!
+ * @brief IndicatorBatchJob
+ * @details runs one job of a batch per task
+ */
+class IndicatorBatchJob : public WorkerJob
+{
+public:
+	IndicatorBatch* batch;
+
+	virtual void run(unsigned int task)
+	{
+		batch->runJob(task);
+	}
+};
+
+RollingSum::RollingSum(unsigned int newWindow) : values((newWindow > 0) ? newWindow : 1, 0.0)
+{
+	head = 0;
+	count = 0;
+	sum = 0.0;
+}
+
+unsigned int RollingSum::getWindow() const
+{
+	return values.size();
+}
+
+unsigned int RollingSum::size() const
+{
+	return count;
+}
+
+bool RollingSum::full() const
+{
+	return count == values.size();
+}
+
+double RollingSum::getSum() const
+{
+	return sum;
+}
+
+/*!
+ * @brief get the oldest value
+ * @return the value that the next push drops once the window is full
+ */
+double RollingSum::getOldest() const
+{
+	if (full())
+		return values[head];
+
+	return values[0];
+}
+
+void RollingSum::push(double value)
+{
+	if (full())
+		sum -= values[head];
+	else
+		++count;
+
+	values[head] = value;
+	sum += value;
+	++head;
+	if (head == values.size())
+		head = 0;
+}
+
+void RollingSum::clear()
+{
+	head = 0;
+	count = 0;
+	sum = 0.0;
+}
+
+StreamSMA::StreamSMA(unsigned int period) : window(period)
+{
+	// put code here to initialize private StreamSMA variables
+}
+
+bool StreamSMA::ready() const
+{
+	return window.full();
+}
+
+/*!
+ * @brief get the value
+ * @return the average of the window, or of the values so far until it fills
+ */
+float StreamSMA::getValue() const
+{
+	if (window.size() == 0)
+		return 0.0f;
+
+	return window.getSum() / window.size();
+}
+
+float StreamSMA::push(float value)
+{
+	window.push(value);
+	return getValue();
+}
+
+void StreamSMA::clear()
+{
+	window.clear();
+}
+
+/*!
+ * @brief apply
+ * @details the simple moving average of a whole column in one pass
+ * @param values the column
+ * @param count the number of values
+ * @param period the window
+ * @param result count values are written here
+ */
+void StreamSMA::apply(const float* values, unsigned int count, unsigned int period, float* result)
+{
+	StreamSMA sma(period);
+	for (unsigned int i = 0; i < count; ++i)
+		result[i] = sma.push(values[i]);
+}
+
+StreamEMA::StreamEMA(unsigned int newPeriod)
+{
+	period = (newPeriod > 0) ? newPeriod : 1;
+	alpha = 2.0 / (period + 1.0);
+	count = 0;
+	value = 0.0;
+}
+
+bool StreamEMA::ready() const
+{
+	return count >= period;
+}
+
+float StreamEMA::getValue() const
+{
+	return value;
+}
+
+/*!
+ * @brief push a value
+ * @details the first period values are averaged to seed the exponential average
+ * @param newValue the newest value
+ * @return the average
+ */
+float StreamEMA::push(float newValue)
+{
+	if (count < period)
+	{
+		++count;
+		value += (newValue - value) / count;
+	}
+	else
+		value += alpha * (newValue - value);
+
+	return value;
+}
+
+void StreamEMA::clear()
+{
+	count = 0;
+	value = 0.0;
+}
+
+void StreamEMA::apply(const float* values, unsigned int count, unsigned int period, float* result)
+{
+	StreamEMA ema(period);
+	for (unsigned int i = 0; i < count; ++i)
+		result[i] = ema.push(values[i]);
+}
+
+StreamROC::StreamROC(unsigned int period) : window(period + 1)
+{
+	value = 0.0f;
+}
+
+bool StreamROC::ready() const
+{
+	return window.full();
+}
+
+float StreamROC::getValue() const
+{
+	return value;
+}
+
+/*!
+ * @brief push a value
+ * @param newValue the newest value
+ * @return the percent change from the value period pushes ago, 0 until the window fills
+ */
+float StreamROC::push(float newValue)
+{
+	window.push(newValue);
+	value = 0.0f;
+	if (!window.full())
+		return value;
+
+	double oldest = window.getOldest();
+	if (oldest != 0.0)
+		value = ((newValue - oldest) / oldest) * 100.0;
+
+	return value;
+}
+
+void StreamROC::clear()
+{
+	window.clear();
+	value = 0.0f;
+}
+
+StreamBollinger::StreamBollinger(unsigned int period, float newDeviations)
+	: values((period > 0) ? period : 1, 0.0f)
+{
+	head = 0;
+	count = 0;
+	deviations = newDeviations;
+	mean = 0.0;
+	m2 = 0.0;
+}
+
+bool StreamBollinger::ready() const
+{
+	return count == values.size();
+}
+
+float StreamBollinger::getMean() const
+{
+	return mean;
+}
+
+/*!
+ * @brief get the deviation
+ * @return the population standard deviation of the window
+ */
+float StreamBollinger::getDeviation() const
+{
+	if (count == 0)
+		return 0.0f;
+
+	return sqrt(m2 / count);
+}
+
+float StreamBollinger::getUpper() const
+{
+	return mean + (deviations * getDeviation());
+}
+
+float StreamBollinger::getLower() const
+{
+	return mean - (deviations * getDeviation());
+}
+
+/*!
+ * @brief push a value
+ * @details a Welford step while the window fills, then a combined step for the value that enters
+ * and the one that leaves
+ * @param value the newest value
+ */
+void StreamBollinger::push(float value)
+{
+	if (count < values.size())
+	{
+		++count;
+		double delta = value - mean;
+		mean += delta / count;
+		m2 += delta * (value - mean);
+	}
+	else
+	{
+		double oldest = values[head];
+		double oldMean = mean;
+		mean += (value - oldest) / count;
+		m2 += (value - oldest) * ((value - mean) + (oldest - oldMean));
+		if (m2 < 0.0)
+			m2 = 0.0;
+	}
+
+	values[head] = value;
+	++head;
+	if (head == values.size())
+		head = 0;
+}
+
+void StreamBollinger::clear()
+{
+	head = 0;
+	count = 0;
+	mean = 0.0;
+	m2 = 0.0;
+}
+
+/*!
+ * @brief apply
+ * @details the bands of a whole column in one pass
+ * @param values the column
+ * @param count the number of values
+ * @param period the window
+ * @param deviations the band width in standard deviations
+ * @param upper count upper band values are written here
+ * @param lower count lower band values are written here
+ */
+void StreamBollinger::apply(const float* values, unsigned int count, unsigned int period,
+							float deviations, float* upper, float* lower)
+{
+	StreamBollinger bands(period, deviations);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		bands.push(values[i]);
+		upper[i] = bands.getUpper();
+		lower[i] = bands.getLower();
+	}
+}
+
+StreamRSI::StreamRSI(unsigned int newPeriod)
+{
+	period = (newPeriod > 0) ? newPeriod : 1;
+	count = 0;
+	prevClose = 0.0f;
+	avgGain = 0.0;
+	avgLoss = 0.0;
+}
+
+bool StreamRSI::ready() const
+{
+	return count > period;
+}
+
+/*!
+ * @brief get the value
+ * @return the RSI in [0, 100], 50 while there is no movement
+ */
+float StreamRSI::getValue() const
+{
+	if (avgLoss == 0.0)
+		return (avgGain == 0.0) ? 50.0f : 100.0f;
+
+	return 100.0 - (100.0 / (1.0 + (avgGain / avgLoss)));
+}
+
+float StreamRSI::push(float close)
+{
+	++count;
+	if (count == 1)
+	{
+		prevClose = close;
+		return getValue();
+	}
+
+	double change = close - prevClose;
+	double gain = (change > 0.0) ? change : 0.0;
+	double loss = (change < 0.0) ? -change : 0.0;
+	prevClose = close;
+
+	// average the first period changes, then smooth
+	unsigned int changes = count - 1;
+	if (changes <= period)
+	{
+		avgGain += (gain - avgGain) / changes;
+		avgLoss += (loss - avgLoss) / changes;
+	}
+	else
+	{
+		avgGain = ((avgGain * (period - 1)) + gain) / period;
+		avgLoss = ((avgLoss * (period - 1)) + loss) / period;
+	}
+
+	return getValue();
+}
+
+void StreamRSI::clear()
+{
+	count = 0;
+	prevClose = 0.0f;
+	avgGain = 0.0;
+	avgLoss = 0.0;
+}
+
+void StreamRSI::apply(const float* values, unsigned int count, unsigned int period, float* result)
+{
+	StreamRSI rsi(period);
+	for (unsigned int i = 0; i < count; ++i)
+		result[i] = rsi.push(values[i]);
+}
+
+StreamOBV::StreamOBV()
+{
+	started = false;
+	prevClose = 0.0f;
+	value = 0.0;
+}
+
+float StreamOBV::getValue() const
+{
+	return value;
+}
+
+/*!
+ * @brief push a bar
+ * @param close the close
+ * @param volume the volume
+ * @return the on balance volume
+ */
+float StreamOBV::push(float close, float volume)
+{
+	if (started)
+	{
+		if (close > prevClose)
+			value += volume;
+		else if (close < prevClose)
+			value -= volume;
+	}
+
+	started = true;
+	prevClose = close;
+	return value;
+}
+
+void StreamOBV::clear()
+{
+	started = false;
+	prevClose = 0.0f;
+	value = 0.0;
+}
+
+StreamStochastic::StreamStochastic(unsigned int newPeriod)
+{
+	period = (newPeriod > 0) ? newPeriod : 1;
+	value = 50.0f;
+}
+
+bool StreamStochastic::ready() const
+{
+	return highs.size() == period;
+}
+
+float StreamStochastic::getValue() const
+{
+	return value;
+}
+
+float StreamStochastic::getHighest() const
+{
+	return highs.getMax();
+}
+
+float StreamStochastic::getLowest() const
+{
+	return lows.getMin();
+}
+
+/*!
+ * @brief push a bar
+ * @param high the high
+ * @param low the low
+ * @param close the close
+ * @return %K in [0, 100], 50 when the window has no range
+ */
+float StreamStochastic::push(float high, float low, float close)
+{
+	if (highs.size() == period)
+	{
+		highs.pop();
+		lows.pop();
+	}
+
+	highs.push(high);
+	lows.push(low);
+
+	float highest = highs.getMax();
+	float lowest = lows.getMin();
+	value = (highest > lowest) ? ((close - lowest) / (highest - lowest)) * 100.0f : 50.0f;
+	return value;
+}
+
+void StreamStochastic::clear()
+{
+	highs.clear();
+	lows.clear();
+	value = 50.0f;
+}
+
+StreamWilliamsR::StreamWilliamsR(unsigned int period) : stochastic(period)
+{
+	// put code here to initialize private StreamWilliamsR variables
+}
+
+bool StreamWilliamsR::ready() const
+{
+	return stochastic.ready();
+}
+
+/*!
+ * @brief get the value
+ * @return %R in [-100, 0]
+ */
+float StreamWilliamsR::getValue() const
+{
+	return stochastic.getValue() - 100.0f;
+}
+
+float StreamWilliamsR::push(float high, float low, float close)
+{
+	stochastic.push(high, low, close);
+	return getValue();
+}
+
+void StreamWilliamsR::clear()
+{
+	stochastic.clear();
+}
+
+StreamMFI::StreamMFI(unsigned int period) : positiveFlow(period), negativeFlow(period)
+{
+	started = false;
+	prevTypical = 0.0f;
+}
+
+bool StreamMFI::ready() const
+{
+	return positiveFlow.full();
+}
+
+/*!
+ * @brief get the value
+ * @return the MFI in [0, 100], 50 while there is no flow
+ */
+float StreamMFI::getValue() const
+{
+	double positive = positiveFlow.getSum();
+	double negative = negativeFlow.getSum();
+	if (negative <= 0.0)
+		return (positive <= 0.0) ? 50.0f : 100.0f;
+
+	return 100.0 - (100.0 / (1.0 + (positive / negative)));
+}
+
+/*!
+ * @brief push a bar
+ * @param high the high
+ * @param low the low
+ * @param close the close
+ * @param volume the volume
+ * @return the money flow index
+ */
+float StreamMFI::push(float high, float low, float close, float volume)
+{
+	float typical = (high + low + close) / 3.0f;
+	if (started)
+	{
+		double flow = (double)typical * volume;
+		positiveFlow.push((typical > prevTypical) ? flow : 0.0);
+		negativeFlow.push((typical < prevTypical) ? flow : 0.0);
+	}
+
+	started = true;
+	prevTypical = typical;
+	return getValue();
+}
+
+void StreamMFI::clear()
+{
+	positiveFlow.clear();
+	negativeFlow.clear();
+	started = false;
+	prevTypical = 0.0f;
+}
+
+StreamVWAP::StreamVWAP(unsigned int period) : priceVolume(period), volume(period)
+{
+	// put code here to initialize private StreamVWAP variables
+}
+
+bool StreamVWAP::ready() const
+{
+	return volume.full();
+}
+
+float StreamVWAP::getValue() const
+{
+	if (volume.getSum() <= 0.0)
+		return 0.0f;
+
+	return priceVolume.getSum() / volume.getSum();
+}
+
+/*!
+ * @brief push a bar
+ * @param high the high
+ * @param low the low
+ * @param close the close
+ * @param barVolume the volume
+ * @return the volume weighted average price of the window
+ */
+float StreamVWAP::push(float high, float low, float close, float barVolume)
+{
+	float typical = (high + low + close) / 3.0f;
+	priceVolume.push((double)typical * barVolume);
+	volume.push(barVolume);
+	return getValue();
+}
+
+void StreamVWAP::clear()
+{
+	priceVolume.clear();
+	volume.clear();
+}
+
+StreamVortex::StreamVortex(unsigned int period)
+	: plusMovement(period), minusMovement(period), trueRange(period)
+{
+	started = false;
+	prevHigh = 0.0f;
+	prevLow = 0.0f;
+	prevClose = 0.0f;
+}
+
+bool StreamVortex::ready() const
+{
+	return trueRange.full();
+}
+
+float StreamVortex::getPlus() const
+{
+	if (trueRange.getSum() <= 0.0)
+		return 0.0f;
+
+	return plusMovement.getSum() / trueRange.getSum();
+}
+
+float StreamVortex::getMinus() const
+{
+	if (trueRange.getSum() <= 0.0)
+		return 0.0f;
+
+	return minusMovement.getSum() / trueRange.getSum();
+}
+
+/*!
+ * @brief push a bar
+ * @param high the high
+ * @param low the low
+ * @param close the close
+ */
+void StreamVortex::push(float high, float low, float close)
+{
+	if (started)
+	{
+		double range = high - low;
+		double fromClose = fabs(high - prevClose);
+		if (fromClose > range)
+			range = fromClose;
+		fromClose = fabs(low - prevClose);
+		if (fromClose > range)
+			range = fromClose;
+
+		plusMovement.push(fabs(high - prevLow));
+		minusMovement.push(fabs(low - prevHigh));
+		trueRange.push(range);
+	}
+
+	started = true;
+	prevHigh = high;
+	prevLow = low;
+	prevClose = close;
+}
+
+void StreamVortex::clear()
+{
+	plusMovement.clear();
+	minusMovement.clear();
+	trueRange.clear();
+	started = false;
+	prevHigh = 0.0f;
+	prevLow = 0.0f;
+	prevClose = 0.0f;
+}
+
+IndicatorBatch::IndicatorBatch()
+{
+	// put code here to initialize private IndicatorBatch variables
+}
+
+IndicatorBatch::~IndicatorBatch()
+{
+	clear();
+}
+
+unsigned int IndicatorBatch::size() const
+{
+	return entries.size();
+}
+
+/*!
+ * @brief get a result
+ * @param job the index returned by addJob
+ * @return the indicator column, one value per input value
+ */
+const std::vector<float>& IndicatorBatch::getResult(unsigned int job) const
+{
+	return entries[job].result;
+}
+
+/*!
+ * @brief add a job
+ * @details the input column is read when the batch runs and must stay alive until then
+ * @param values the input column
+ * @param count the number of values
+ * @param indicator the indicator, SMA through BOLLINGER_LOWER
+ * @param period the indicator window
+ * @param deviations the band width of the Bollinger indicators
+ * @return the job index
+ */
+unsigned int IndicatorBatch::addJob(const float* values, unsigned int count, int indicator,
+									unsigned int period, float deviations)
+{
+	Entry newEntry;
+	newEntry.values = values;
+	newEntry.count = values ? count : 0;
+	newEntry.indicator = indicator;
+	newEntry.period = period;
+	newEntry.deviations = deviations;
+	entries.push_back(newEntry);
+
+	return entries.size() - 1;
+}
+
+void IndicatorBatch::clear()
+{
+	entries.clear();
+}
+
+/*!
+ * @brief run
+ * @details allocates every result column, then runs the jobs across the pool
+ * @param pool the pool, the shared pool by default
+ */
+void IndicatorBatch::run(WorkerPool* pool)
+{
+	if (entries.empty())
+		return;
+
+	for (unsigned int i = 0; i < entries.size(); ++i)
+		entries[i].result.resize(entries[i].count);
+
+	if (!pool)
+		pool = WorkerPool::getSharedPool();
+
+	IndicatorBatchJob batchJob;
+	batchJob.batch = this;
+	pool->run(&batchJob, entries.size());
+}
+
+/*!
+ * @brief run a job
+ * @details computes one result column, called by the workers
+ * @param job the job index
+ */
+void IndicatorBatch::runJob(unsigned int job)
+{
+	Entry& cEntry = entries[job];
+	if (cEntry.count == 0)
+		return;
+
+	float* result = &cEntry.result[0];
+	if (cEntry.indicator == SMA)
+		StreamSMA::apply(cEntry.values, cEntry.count, cEntry.period, result);
+	else if (cEntry.indicator == EMA)
+		StreamEMA::apply(cEntry.values, cEntry.count, cEntry.period, result);
+	else if (cEntry.indicator == RSI)
+		StreamRSI::apply(cEntry.values, cEntry.count, cEntry.period, result);
+	else if (cEntry.indicator == ROC)
+	{
+		StreamROC roc(cEntry.period);
+		for (unsigned int i = 0; i < cEntry.count; ++i)
+			result[i] = roc.push(cEntry.values[i]);
+	}
+	else if ((cEntry.indicator == BOLLINGER_UPPER) || (cEntry.indicator == BOLLINGER_LOWER))
+	{
+		StreamBollinger bands(cEntry.period, cEntry.deviations);
+		bool upper = (cEntry.indicator == BOLLINGER_UPPER);
+		for (unsigned int i = 0; i < cEntry.count; ++i)
+		{
+			bands.push(cEntry.values[i]);
+			result[i] = upper ? bands.getUpper() : bands.getLower();
+		}
+	}
+}
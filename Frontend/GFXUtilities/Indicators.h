@@ -0,0 +1,329 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GINDICATORS
+#define _GINDICATORS
+
+#include "RangeTracker.h"
+#include "WorkerPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief Streaming indicators
+ * @details Rolling versions of the shmea::GAnalysis indicators for live charts. Each one keeps its
+ * window state and takes one bar per push in O(1): running sums for the averages and flows,
+ * Welford updates for the variance and monotonic deques for the windowed highs and lows. Sums are
+ * kept in double so long streams do not drift. The static apply functions run an indicator over
+ * whole columns in one pass into a caller buffer.
+ */
+
+/*!
+ * @brief RollingSum
+ * @details Sum of the last n values
+ */
+class RollingSum
+{
+private:
+	std::vector<double> values;
+	unsigned int head;
+	unsigned int count;
+	double sum;
+
+public:
+	RollingSum(unsigned int = 1);
+
+	unsigned int getWindow() const;
+	unsigned int size() const;
+	bool full() const;
+	double getSum() const;
+	double getOldest() const;
+
+	void push(double);
+	void clear();
+};
+
+class StreamSMA
+{
+private:
+	RollingSum window;
+
+public:
+	StreamSMA(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float);
+	void clear();
+
+	static void apply(const float*, unsigned int, unsigned int, float*);
+};
+
+class StreamEMA
+{
+private:
+	unsigned int period;
+	unsigned int count;
+	double alpha;
+	double value;
+
+public:
+	StreamEMA(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float);
+	void clear();
+
+	static void apply(const float*, unsigned int, unsigned int, float*);
+};
+
+class StreamROC
+{
+private:
+	RollingSum window;
+	float value;
+
+public:
+	StreamROC(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float);
+	void clear();
+};
+
+/*!
+ * @brief StreamBollinger
+ * @details Moving average with bands k standard deviations away, the variance is updated with
+ * Welford's method as values enter and leave the window
+ */
+class StreamBollinger
+{
+private:
+	std::vector<float> values;
+	unsigned int head;
+	unsigned int count;
+	float deviations;
+	double mean;
+	double m2;
+
+public:
+	StreamBollinger(unsigned int, float = 2.0f);
+
+	bool ready() const;
+	float getMean() const;
+	float getDeviation() const;
+	float getUpper() const;
+	float getLower() const;
+	void push(float);
+	void clear();
+
+	static void apply(const float*, unsigned int, unsigned int, float, float*, float*);
+};
+
+/*!
+ * @brief StreamRSI
+ * @details Relative strength index with Wilder smoothing, seeded by the average of the first
+ * period changes
+ */
+class StreamRSI
+{
+private:
+	unsigned int period;
+	unsigned int count;
+	float prevClose;
+	double avgGain;
+	double avgLoss;
+
+public:
+	StreamRSI(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float);
+	void clear();
+
+	static void apply(const float*, unsigned int, unsigned int, float*);
+};
+
+class StreamOBV
+{
+private:
+	bool started;
+	float prevClose;
+	double value;
+
+public:
+	StreamOBV();
+
+	float getValue() const;
+	float push(float, float);
+	void clear();
+};
+
+/*!
+ * @brief StreamStochastic
+ * @details Stochastic %K, the close against the highest high and lowest low of the window
+ */
+class StreamStochastic
+{
+private:
+	unsigned int period;
+	RangeTracker highs;
+	RangeTracker lows;
+	float value;
+
+public:
+	StreamStochastic(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float getHighest() const;
+	float getLowest() const;
+	float push(float, float, float);
+	void clear();
+};
+
+class StreamWilliamsR
+{
+private:
+	StreamStochastic stochastic;
+
+public:
+	StreamWilliamsR(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float, float, float);
+	void clear();
+};
+
+/*!
+ * @brief StreamMFI
+ * @details Money flow index, the positive and negative money flow of the window
+ */
+class StreamMFI
+{
+private:
+	RollingSum positiveFlow;
+	RollingSum negativeFlow;
+	bool started;
+	float prevTypical;
+
+public:
+	StreamMFI(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float, float, float, float);
+	void clear();
+};
+
+/*!
+ * @brief StreamVWAP
+ * @details Volume weighted average of the typical price over the window
+ */
+class StreamVWAP
+{
+private:
+	RollingSum priceVolume;
+	RollingSum volume;
+
+public:
+	StreamVWAP(unsigned int);
+
+	bool ready() const;
+	float getValue() const;
+	float push(float, float, float, float);
+	void clear();
+};
+
+/*!
+ * @brief StreamVortex
+ * @details Positive and negative vortex movement over the true range of the window
+ */
+class StreamVortex
+{
+private:
+	RollingSum plusMovement;
+	RollingSum minusMovement;
+	RollingSum trueRange;
+	bool started;
+	float prevHigh;
+	float prevLow;
+	float prevClose;
+
+public:
+	StreamVortex(unsigned int);
+
+	bool ready() const;
+	float getPlus() const;
+	float getMinus() const;
+	void push(float, float, float);
+	void clear();
+};
+
+/*!
+ * @brief IndicatorBatch
+ * @details Runs many (column, indicator) jobs at once across a WorkerPool, e.g. every indicator of
+ * every instrument after a reload. The result columns are allocated before the workers start and
+ * each job writes only its own column, so nothing is locked and the results come back in the order
+ * the jobs were added.
+ */
+class IndicatorBatch
+{
+private:
+	class Entry
+	{
+	public:
+		const float* values;
+		unsigned int count;
+		int indicator;
+		unsigned int period;
+		float deviations;
+		std::vector<float> result;
+	};
+
+	std::vector<Entry> entries;
+
+public:
+	static const int SMA = 0;
+	static const int EMA = 1;
+	static const int ROC = 2;
+	static const int RSI = 3;
+	static const int BOLLINGER_UPPER = 4;
+	static const int BOLLINGER_LOWER = 5;
+
+	// constructors & destructor
+	IndicatorBatch();
+	~IndicatorBatch();
+
+	// gets
+	unsigned int size() const;
+	const std::vector<float>& getResult(unsigned int) const;
+
+	// sets
+	unsigned int addJob(const float*, unsigned int, int, unsigned int, float = 2.0f);
+	void clear();
+
+	// run
+	void run(WorkerPool* = NULL);
+	void runJob(unsigned int);
+};
+
+#endif
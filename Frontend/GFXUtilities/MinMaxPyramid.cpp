@@ -0,0 +1,250 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "MinMaxPyramid.h"
+#include <algorithm>
+
+MinMaxPyramid::MinMaxPyramid()
+{
+	offset = 0;
+}
+
+MinMaxPyramid::~MinMaxPyramid()
+{
+	clear();
+}
+
+unsigned int MinMaxPyramid::size() const
+{
+	return values.size() - offset;
+}
+
+bool MinMaxPyramid::empty() const
+{
+	return values.size() == offset;
+}
+
+float MinMaxPyramid::get(unsigned int index) const
+{
+	return values[offset + index];
+}
+
+/*!
+ * @brief get the range of a run
+ * @details walks up the pyramid from both ends of the run, taking the blocks that fall inside it
+ * @param first the index of the first value
+ * @param last one past the index of the last value
+ * @param minValue set to the smallest value in [first, last)
+ * @param maxValue set to the largest value in [first, last)
+ * @return false if the run is empty
+ */
+bool MinMaxPyramid::getRange(unsigned int first, unsigned int last, float& minValue,
+							 float& maxValue) const
+{
+	if (last > size())
+		last = size();
+	if (first >= last)
+		return false;
+
+	unsigned int begin = offset + first;
+	unsigned int end = offset + last;
+
+	// the values themselves
+	minValue = values[begin];
+	maxValue = minValue;
+	if (begin & 1)
+		++begin;
+	if ((end & 1) && (end > begin))
+	{
+		--end;
+		if (values[end] < minValue)
+			minValue = values[end];
+		if (values[end] > maxValue)
+			maxValue = values[end];
+	}
+	begin >>= 1;
+	end >>= 1;
+
+	// whole blocks
+	for (unsigned int level = 0; (begin < end) && (level < minLevels.size()); ++level)
+	{
+		const std::vector<float>& mins = minLevels[level];
+		const std::vector<float>& maxs = maxLevels[level];
+		if (begin & 1)
+		{
+			if (mins[begin] < minValue)
+				minValue = mins[begin];
+			if (maxs[begin] > maxValue)
+				maxValue = maxs[begin];
+			++begin;
+		}
+
+		if (end & 1)
+		{
+			--end;
+			if (mins[end] < minValue)
+				minValue = mins[end];
+			if (maxs[end] > maxValue)
+				maxValue = maxs[end];
+		}
+
+		begin >>= 1;
+		end >>= 1;
+	}
+
+	return true;
+}
+
+void MinMaxPyramid::reserve(unsigned int capacity)
+{
+	values.reserve(capacity);
+}
+
+/*!
+ * @brief push a value
+ * @details adds the newest value and widens the one block that holds it on every level
+ * @param value the newest value
+ */
+void MinMaxPyramid::push(float value)
+{
+	values.push_back(value);
+	unsigned int index = values.size() - 1;
+
+	for (unsigned int level = 0; level < minLevels.size(); ++level)
+	{
+		index >>= 1;
+		std::vector<float>& mins = minLevels[level];
+		std::vector<float>& maxs = maxLevels[level];
+		if (index == mins.size())
+		{
+			mins.push_back(value);
+			maxs.push_back(value);
+			continue;
+		}
+
+		if (value < mins[index])
+			mins[index] = value;
+		if (value > maxs[index])
+			maxs[index] = value;
+	}
+
+	// the top level always holds one block
+	while ((minLevels.empty() ? values.size() : minLevels.back().size()) > 1)
+		addLevel();
+}
+
+/*!
+ * @brief pop a value
+ * @details drops the oldest value. The stale values are only cleared out once they make up half
+ * the storage.
+ */
+void MinMaxPyramid::pop()
+{
+	if (empty())
+		return;
+
+	++offset;
+	if (offset == values.size())
+		clear();
+	else if (offset >= values.size() - offset)
+		compact();
+}
+
+/*!
+ * @brief set the values
+ * @details replaces the series and builds the pyramid bottom up
+ * @param newValues the values
+ * @param count the number of values
+ */
+void MinMaxPyramid::setValues(const float* newValues, unsigned int count)
+{
+	clear();
+	if ((!newValues) || (count == 0))
+		return;
+
+	values.assign(newValues, newValues + count);
+	while ((minLevels.empty() ? values.size() : minLevels.back().size()) > 1)
+		addLevel();
+}
+
+/*!
+ * @brief swap
+ * @details exchanges the values and levels of two pyramids without copying
+ * @param other the pyramid to swap with
+ */
+void MinMaxPyramid::swap(MinMaxPyramid& other)
+{
+	values.swap(other.values);
+	minLevels.swap(other.minLevels);
+	maxLevels.swap(other.maxLevels);
+	std::swap(offset, other.offset);
+}
+
+void MinMaxPyramid::clear()
+{
+	values.clear();
+	minLevels.clear();
+	maxLevels.clear();
+	offset = 0;
+}
+
+/*!
+ * @brief add a level
+ * @details builds the next level of the pyramid from the top one
+ */
+void MinMaxPyramid::addLevel()
+{
+	unsigned int level = minLevels.size();
+	const std::vector<float>& lowerMins = (level == 0) ? values : minLevels[level - 1];
+	const std::vector<float>& lowerMaxs = (level == 0) ? values : maxLevels[level - 1];
+	const unsigned int lowerCount = lowerMins.size();
+
+	std::vector<float> mins((lowerCount + 1) / 2);
+	std::vector<float> maxs(mins.size());
+	for (unsigned int i = 0; i < mins.size(); ++i)
+	{
+		unsigned int left = i * 2;
+		mins[i] = lowerMins[left];
+		maxs[i] = lowerMaxs[left];
+		if (left + 1 < lowerCount)
+		{
+			if (lowerMins[left + 1] < mins[i])
+				mins[i] = lowerMins[left + 1];
+			if (lowerMaxs[left + 1] > maxs[i])
+				maxs[i] = lowerMaxs[left + 1];
+		}
+	}
+
+	minLevels.push_back(std::vector<float>());
+	maxLevels.push_back(std::vector<float>());
+	minLevels.back().swap(mins);
+	maxLevels.back().swap(maxs);
+}
+
+/*!
+ * @brief compact
+ * @details drops the popped values and rebuilds the pyramid from the live ones
+ */
+void MinMaxPyramid::compact()
+{
+	values.erase(values.begin(), values.begin() + offset);
+	offset = 0;
+
+	minLevels.clear();
+	maxLevels.clear();
+	while ((minLevels.empty() ? values.size() : minLevels.back().size()) > 1)
+		addLevel();
+}
@@ -0,0 +1,64 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GMINMAXPYRAMID
+#define _GMINMAXPYRAMID
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief MinMaxPyramid
+ * @details Min and max of any run of a series in O(log n). Level k holds the bounds of aligned
+ * blocks of 2^k values; a query is answered from at most two blocks per level. Pushing the newest
+ * value updates one block per level, and popping the oldest only moves an offset until half the
+ * storage is stale, so both are O(log n) amortized.
+ */
+
+class MinMaxPyramid
+{
+private:
+	// level 0 is the values themselves
+	std::vector<float> values;
+	std::vector<std::vector<float> > minLevels;
+	std::vector<std::vector<float> > maxLevels;
+	unsigned int offset;
+
+	void addLevel();
+	void compact();
+
+public:
+	// constructors & destructor
+	MinMaxPyramid();
+	~MinMaxPyramid();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	float get(unsigned int) const;
+	bool getRange(unsigned int, unsigned int, float&, float&) const;
+
+	// sets
+	void reserve(unsigned int);
+	void push(float);
+	void pop();
+	void setValues(const float*, unsigned int);
+	void swap(MinMaxPyramid&);
+	void clear();
+};
+
+#endif
@@ -0,0 +1,328 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "PointGrid.h"
+#include <float.h>
+#include <math.h>
+
+// cells further out than this share the edge cell
+static const float MAX_CELL = 1073741824.0f;
+
+PointGrid::PointGrid()
+{
+	originX = 0.0f;
+	originY = 0.0f;
+	cellWidth = 1.0f;
+	cellHeight = 1.0f;
+	minCellX = 0;
+	maxCellX = -1;
+	minCellY = 0;
+	maxCellY = -1;
+	headSeq = 0;
+	nextSeq = 0;
+	builtSize = 0;
+}
+
+PointGrid::~PointGrid()
+{
+	clear();
+}
+
+unsigned int PointGrid::size() const
+{
+	return nextSeq - headSeq;
+}
+
+bool PointGrid::empty() const
+{
+	return nextSeq == headSeq;
+}
+
+/*!
+ * @brief needs rebuild
+ * @details the cell size is picked when the grid is built, so cells get crowded as points are
+ * pushed. Rebuilding each time the size doubles keeps pushes O(log n) amortized.
+ * @return true once the grid has doubled in size since it was built
+ */
+bool PointGrid::needsRebuild() const
+{
+	unsigned int minSize = (builtSize > POINTS_PER_CELL) ? builtSize : POINTS_PER_CELL;
+	return size() >= minSize * 2;
+}
+
+PointGrid::Cell PointGrid::getCell(float x, float y) const
+{
+	float cellX = floorf((x - originX) / cellWidth);
+	float cellY = floorf((y - originY) / cellHeight);
+
+	if (!(cellX > -MAX_CELL))
+		cellX = -MAX_CELL;
+	else if (cellX > MAX_CELL)
+		cellX = MAX_CELL;
+
+	if (!(cellY > -MAX_CELL))
+		cellY = -MAX_CELL;
+	else if (cellY > MAX_CELL)
+		cellY = MAX_CELL;
+
+	return Cell((int)cellY, (int)cellX);
+}
+
+/*!
+ * @brief build
+ * @details indexes a series, sizing the cells so an even spread holds POINTS_PER_CELL points each
+ * @param xValues the x column
+ * @param yValues the y column
+ * @param count the number of points
+ */
+void PointGrid::build(const float* xValues, const float* yValues, unsigned int count)
+{
+	clear();
+	builtSize = count;
+	if ((!xValues) || (!yValues) || (count == 0))
+		return;
+
+	float xMin = xValues[0], xMax = xValues[0];
+	float yMin = yValues[0], yMax = yValues[0];
+	for (unsigned int i = 1; i < count; ++i)
+	{
+		if (xValues[i] < xMin)
+			xMin = xValues[i];
+		if (xValues[i] > xMax)
+			xMax = xValues[i];
+		if (yValues[i] < yMin)
+			yMin = yValues[i];
+		if (yValues[i] > yMax)
+			yMax = yValues[i];
+	}
+
+	float cellsPerSide = sqrtf(((float)count) / POINTS_PER_CELL);
+	if (cellsPerSide < 1.0f)
+		cellsPerSide = 1.0f;
+
+	originX = xMin;
+	originY = yMin;
+	cellWidth = (xMax > xMin) ? (xMax - xMin) / cellsPerSide : 1.0f;
+	cellHeight = (yMax > yMin) ? (yMax - yMin) / cellsPerSide : 1.0f;
+
+	for (unsigned int i = 0; i < count; ++i)
+		push(xValues[i], yValues[i]);
+}
+
+/*!
+ * @brief push a point
+ * @details indexes the newest point of the series
+ */
+void PointGrid::push(float x, float y)
+{
+	Cell cell = getCell(x, y);
+	cells[cell].push_back(nextSeq);
+	++nextSeq;
+
+	if (minCellX > maxCellX)
+	{
+		minCellY = maxCellY = cell.first;
+		minCellX = maxCellX = cell.second;
+		return;
+	}
+
+	if (cell.first < minCellY)
+		minCellY = cell.first;
+	if (cell.first > maxCellY)
+		maxCellY = cell.first;
+	if (cell.second < minCellX)
+		minCellX = cell.second;
+	if (cell.second > maxCellX)
+		maxCellX = cell.second;
+}
+
+/*!
+ * @brief pop a point
+ * @details drops the oldest point of the series, the caller passes its coordinates
+ */
+void PointGrid::pop(float x, float y)
+{
+	if (empty())
+		return;
+
+	CellMap::iterator it = cells.find(getCell(x, y));
+	if ((it != cells.end()) && (!it->second.empty()) && (it->second.front() == headSeq))
+	{
+		it->second.erase(it->second.begin());
+		if (it->second.empty())
+			cells.erase(it);
+	}
+
+	++headSeq;
+	if (empty())
+		clear();
+}
+
+void PointGrid::clear()
+{
+	cells.clear();
+	minCellX = 0;
+	maxCellX = -1;
+	minCellY = 0;
+	maxCellY = -1;
+	headSeq = 0;
+	nextSeq = 0;
+}
+
+void PointGrid::nearestInCell(const Cell& cell, const float* xValues, const float* yValues,
+							  float x, float y, float xScale, float yScale, float& bestDistanceSq,
+							  unsigned int& index) const
+{
+	CellMap::const_iterator it = cells.find(cell);
+	if (it == cells.end())
+		return;
+
+	const std::vector<unsigned long>& seqs = it->second;
+	for (unsigned int i = 0; i < seqs.size(); ++i)
+	{
+		unsigned int cIndex = seqs[i] - headSeq;
+		float deltaX = (xValues[cIndex] - x) * xScale;
+		float deltaY = (yValues[cIndex] - y) * yScale;
+		float distanceSq = (deltaX * deltaX) + (deltaY * deltaY);
+		if (distanceSq < bestDistanceSq)
+		{
+			bestDistanceSq = distanceSq;
+			index = cIndex;
+		}
+	}
+}
+
+/*!
+ * @brief nearest point
+ * @details searches rings of cells outward from the query until no closer point can remain.
+ * Distances are measured after scaling each axis, so the nearest point on screen can be found
+ * from data coordinates.
+ * @param xValues the x column of the indexed series
+ * @param yValues the y column of the indexed series
+ * @param x the query x
+ * @param y the query y
+ * @param xScale the scale of the x axis, pixels per x unit
+ * @param yScale the scale of the y axis, pixels per y unit
+ * @param index set to the index of the nearest point in the columns
+ * @param distance set to the scaled distance to the nearest point
+ * @return false if the grid is empty
+ */
+bool PointGrid::nearest(const float* xValues, const float* yValues, float x, float y,
+						float xScale, float yScale, unsigned int& index, float& distance) const
+{
+	if (empty())
+		return false;
+
+	const Cell center = getCell(x, y);
+	const int centerRow = center.first;
+	const int centerCol = center.second;
+	float cellStep = cellWidth * xScale;
+	if (cellHeight * yScale < cellStep)
+		cellStep = cellHeight * yScale;
+
+	float bestDistanceSq = FLT_MAX;
+	for (int ring = 0;; ++ring)
+	{
+		// every point in this ring is at least ring - 1 cells away
+		if ((bestDistanceSq < FLT_MAX) && (ring > 0))
+		{
+			float ringDistance = (ring - 1) * cellStep;
+			if (ringDistance * ringDistance > bestDistanceSq)
+				break;
+		}
+
+		// the ring is past every occupied cell
+		if ((centerCol - ring < minCellX) && (centerCol + ring > maxCellX) &&
+			(centerRow - ring < minCellY) && (centerRow + ring > maxCellY))
+			break;
+
+		int rowStart = (centerRow - ring < minCellY) ? minCellY : centerRow - ring;
+		int rowEnd = (centerRow + ring > maxCellY) ? maxCellY : centerRow + ring;
+		int colStart = (centerCol - ring < minCellX) ? minCellX : centerCol - ring;
+		int colEnd = (centerCol + ring > maxCellX) ? maxCellX : centerCol + ring;
+		for (int row = rowStart; row <= rowEnd; ++row)
+		{
+			// whole rows at the top and bottom of the ring
+			if ((row == centerRow - ring) || (row == centerRow + ring))
+			{
+				for (int col = colStart; col <= colEnd; ++col)
+					nearestInCell(Cell(row, col), xValues, yValues, x, y, xScale, yScale,
+								  bestDistanceSq, index);
+				continue;
+			}
+
+			// the two side cells in between
+			if (centerCol - ring >= minCellX)
+				nearestInCell(Cell(row, centerCol - ring), xValues, yValues, x, y, xScale, yScale,
+							  bestDistanceSq, index);
+			if (centerCol + ring <= maxCellX)
+				nearestInCell(Cell(row, centerCol + ring), xValues, yValues, x, y, xScale, yScale,
+							  bestDistanceSq, index);
+		}
+	}
+
+	if (!(bestDistanceSq < FLT_MAX))
+		return false;
+
+	distance = sqrtf(bestDistanceSq);
+	return true;
+}
+
+/*!
+ * @brief rectangle query
+ * @details appends the index of every point inside [x1, x2] x [y1, y2]
+ * @param xValues the x column of the indexed series
+ * @param yValues the y column of the indexed series
+ * @param x1 the left edge
+ * @param y1 the bottom edge
+ * @param x2 the right edge
+ * @param y2 the top edge
+ * @param indices the indices are appended here
+ */
+void PointGrid::query(const float* xValues, const float* yValues, float x1, float y1, float x2,
+					  float y2, std::vector<unsigned int>& indices) const
+{
+	if (empty())
+		return;
+
+	Cell low = getCell(x1, y1);
+	Cell high = getCell(x2, y2);
+	int rowStart = (low.first < minCellY) ? minCellY : low.first;
+	int rowEnd = (high.first > maxCellY) ? maxCellY : high.first;
+
+	for (int row = rowStart; row <= rowEnd; ++row)
+	{
+		// walk the occupied cells of the row in order
+		CellMap::const_iterator it = cells.lower_bound(Cell(row, low.second));
+		CellMap::const_iterator end = cells.upper_bound(Cell(row, high.second));
+		for (; it != end; ++it)
+		{
+			// cells strictly inside the rectangle take every point
+			int col = it->first.second;
+			bool inside = (col > low.second) && (col < high.second) && (row > low.first) &&
+						  (row < high.first);
+
+			const std::vector<unsigned long>& seqs = it->second;
+			for (unsigned int i = 0; i < seqs.size(); ++i)
+			{
+				unsigned int cIndex = seqs[i] - headSeq;
+				if ((inside) || ((xValues[cIndex] >= x1) && (xValues[cIndex] <= x2) &&
+								 (yValues[cIndex] >= y1) && (yValues[cIndex] <= y2)))
+					indices.push_back(cIndex);
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GPOINTGRID
+#define _GPOINTGRID
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief PointGrid
+ * @details Spatial index over a series of 2D points for nearest point and rectangle queries. Points
+ * are bucketed into square cells of a uniform grid, only occupied cells are stored and looked up in
+ * O(log cells). The index holds sequence numbers, not coordinates; the caller passes the x and y
+ * columns of the series to each query. Points are pushed at the back and popped at the front so a
+ * sliding window can be followed.
+ */
+
+class PointGrid
+{
+private:
+	// (row, column), so the cells of a row are adjacent in the map
+	typedef std::pair<int, int> Cell;
+	typedef std::map<Cell, std::vector<unsigned long> > CellMap;
+
+	CellMap cells;
+	float originX;
+	float originY;
+	float cellWidth;
+	float cellHeight;
+	int minCellX, maxCellX, minCellY, maxCellY;
+	unsigned long headSeq;
+	unsigned long nextSeq;
+	unsigned int builtSize;
+
+	Cell getCell(float, float) const;
+	void nearestInCell(const Cell&, const float*, const float*, float, float, float, float,
+					   float&, unsigned int&) const;
+
+public:
+	static const unsigned int POINTS_PER_CELL = 8;
+
+	// constructors & destructor
+	PointGrid();
+	~PointGrid();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	bool needsRebuild() const;
+	bool nearest(const float*, const float*, float, float, float, float, unsigned int&,
+				 float&) const;
+	void query(const float*, const float*, float, float, float, float,
+			   std::vector<unsigned int>&) const;
+
+	// sets
+	void build(const float*, const float*, unsigned int);
+	void push(float, float);
+	void pop(float, float);
+	void clear();
+};
+
+#endif
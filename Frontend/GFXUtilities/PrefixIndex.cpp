@@ -0,0 +1,160 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "PrefixIndex.h"
+#include <ctype.h>
+
+PrefixIndex::PrefixIndex()
+{
+	first = 0;
+	last = 0;
+}
+
+PrefixIndex::~PrefixIndex()
+{
+	clear();
+}
+
+/*!
+ * @brief size
+ * @return the number of strings matching the prefix
+ */
+unsigned int PrefixIndex::size() const
+{
+	return last - first;
+}
+
+bool PrefixIndex::empty() const
+{
+	return (last == first);
+}
+
+/*!
+ * @brief get a match
+ * @param index the match, in key order
+ * @return the index of the matching string in the built list
+ */
+unsigned int PrefixIndex::get(unsigned int index) const
+{
+	return order.get(first + index);
+}
+
+std::string PrefixIndex::getPrefix() const
+{
+	return prefix;
+}
+
+/*!
+ * @brief to key
+ * @param text the text
+ * @return the text in lower case, as it is compared
+ */
+std::string PrefixIndex::toKey(const std::string& text)
+{
+	std::string key = text;
+	for (unsigned int i = 0; i < key.length(); ++i)
+		key[i] = tolower((unsigned char)key[i]);
+
+	return key;
+}
+
+/*!
+ * @brief build
+ * @details sorts the strings by key, and matches every string
+ * @param strings the strings to search
+ * @param pool the workers to sort with, NULL for the shared pool
+ */
+void PrefixIndex::build(const std::vector<std::string>& strings, WorkerPool* pool)
+{
+	keys.resize(strings.size());
+	for (unsigned int i = 0; i < strings.size(); ++i)
+		keys[i] = toKey(strings[i]);
+
+	order.reset(keys.size());
+	order.sort(keys, true, pool);
+
+	prefix = "";
+	first = 0;
+	last = keys.size();
+}
+
+/*!
+ * @brief set the prefix
+ * @details a prefix that extends the last one only searches the last matches
+ * @param newPrefix the text the matches start with
+ */
+void PrefixIndex::setPrefix(const std::string& newPrefix)
+{
+	std::string newKey = toKey(newPrefix);
+	unsigned int searchFirst = first;
+	unsigned int searchLast = last;
+	if (newKey.compare(0, prefix.length(), prefix) != 0)
+	{
+		searchFirst = 0;
+		searchLast = keys.size();
+	}
+
+	prefix = newKey;
+	first = lowerBound(searchFirst, searchLast, prefix);
+	last = upperBound(first, searchLast, prefix);
+}
+
+/*!
+ * @brief lower bound
+ * @return the first position in [lo, hi) whose key is not below the prefix
+ */
+unsigned int PrefixIndex::lowerBound(unsigned int lo, unsigned int hi,
+									 const std::string& key) const
+{
+	while (lo < hi)
+	{
+		unsigned int mid = lo + ((hi - lo) / 2);
+		if (keys[order.get(mid)] < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/*!
+ * @brief upper bound
+ * @return the first position in [lo, hi) whose key does not start with the prefix
+ */
+unsigned int PrefixIndex::upperBound(unsigned int lo, unsigned int hi,
+									 const std::string& key) const
+{
+	while (lo < hi)
+	{
+		unsigned int mid = lo + ((hi - lo) / 2);
+		if (keys[order.get(mid)].compare(0, key.length(), key) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+void PrefixIndex::clear()
+{
+	keys.clear();
+	order.clear();
+	prefix = "";
+	first = 0;
+	last = 0;
+}
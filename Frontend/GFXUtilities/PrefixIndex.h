@@ -0,0 +1,65 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GPREFIXINDEX
+#define _GPREFIXINDEX
+
+#include "RowIndex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+/*!
+ * @brief PrefixIndex
+ * @details Case-insensitive prefix search over a list of strings, e.g. the options of a listbox.
+ * The keys are sorted once, so the matches of a prefix are one contiguous range. Extending the
+ * prefix only searches inside the current range, so each typed character narrows the last result.
+ */
+
+class PrefixIndex
+{
+private:
+	std::vector<std::string> keys;
+	RowIndex order;
+	std::string prefix;
+	unsigned int first;
+	unsigned int last;
+
+	unsigned int lowerBound(unsigned int, unsigned int, const std::string&) const;
+	unsigned int upperBound(unsigned int, unsigned int, const std::string&) const;
+
+public:
+	// constructors & destructor
+	PrefixIndex();
+	~PrefixIndex();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	unsigned int get(unsigned int) const;
+	std::string getPrefix() const;
+	static std::string toKey(const std::string&);
+
+	// sets
+	void build(const std::vector<std::string>&, WorkerPool* = NULL);
+	void setPrefix(const std::string&);
+	void clear();
+};
+
+#endif
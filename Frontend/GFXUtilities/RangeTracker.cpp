@@ -0,0 +1,170 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "RangeTracker.h"
+#include <math.h>
+
+RangeTracker::RangeTracker()
+{
+	headSeq = 0;
+	nextSeq = 0;
+}
+
+RangeTracker::~RangeTracker()
+{
+	clear();
+}
+
+unsigned int RangeTracker::size() const
+{
+	return nextSeq - headSeq;
+}
+
+bool RangeTracker::empty() const
+{
+	return nextSeq == headSeq;
+}
+
+float RangeTracker::getMin() const
+{
+	if (minQueue.empty())
+		return 0.0f;
+
+	return minQueue.front().second;
+}
+
+float RangeTracker::getMax() const
+{
+	if (maxQueue.empty())
+		return 0.0f;
+
+	return maxQueue.front().second;
+}
+
+/*!
+ * @brief push a value
+ * @details adds the newest value to the window. Values it dominates can never be a bound again
+ * and are dropped from the back of each queue.
+ * @param value the newest value
+ */
+void RangeTracker::push(float value)
+{
+	while ((!minQueue.empty()) && (minQueue.back().second >= value))
+		minQueue.pop_back();
+	minQueue.push_back(Entry(nextSeq, value));
+
+	while ((!maxQueue.empty()) && (maxQueue.back().second <= value))
+		maxQueue.pop_back();
+	maxQueue.push_back(Entry(nextSeq, value));
+
+	++nextSeq;
+}
+
+/*!
+ * @brief pop a value
+ * @details drops the oldest value from the window
+ */
+void RangeTracker::pop()
+{
+	if (empty())
+		return;
+
+	if ((!minQueue.empty()) && (minQueue.front().first == headSeq))
+		minQueue.pop_front();
+
+	if ((!maxQueue.empty()) && (maxQueue.front().first == headSeq))
+		maxQueue.pop_front();
+
+	++headSeq;
+}
+
+void RangeTracker::clear()
+{
+	minQueue.clear();
+	maxQueue.clear();
+	headSeq = 0;
+	nextSeq = 0;
+}
+
+/*!
+ * @brief nice number
+ * @details rounds a value to 1, 2, 5 or 10 times a power of ten
+ * @param value the value to round
+ * @param round round to the closest nice number instead of the next one up
+ * @return the nice number
+ */
+float RangeTracker::niceNumber(float value, bool round)
+{
+	if (value <= 0.0f)
+		return 0.0f;
+
+	float exponent = floorf(log10f(value));
+	float power = powf(10.0f, exponent);
+	float fraction = value / power;
+
+	float niceFraction = 10.0f;
+	if (round)
+	{
+		if (fraction < 1.5f)
+			niceFraction = 1.0f;
+		else if (fraction < 3.0f)
+			niceFraction = 2.0f;
+		else if (fraction < 7.0f)
+			niceFraction = 5.0f;
+	}
+	else
+	{
+		if (fraction <= 1.0f)
+			niceFraction = 1.0f;
+		else if (fraction <= 2.0f)
+			niceFraction = 2.0f;
+		else if (fraction <= 5.0f)
+			niceFraction = 5.0f;
+	}
+
+	return niceFraction * power;
+}
+
+/*!
+ * @brief nice range
+ * @details widens [minValue, maxValue] out to the closest multiples of a nice tick step
+ * @param minValue the low end, snapped down
+ * @param maxValue the high end, snapped up
+ * @param tickCount the number of ticks the range is split into
+ */
+void RangeTracker::niceRange(float& minValue, float& maxValue, unsigned int tickCount)
+{
+	if (tickCount < 1)
+		tickCount = 1;
+
+	// give a flat range some height
+	if (maxValue <= minValue)
+	{
+		float pad = fabsf(minValue) * 0.1f;
+		if (pad <= 0.0f)
+			pad = 1.0f;
+		minValue -= pad;
+		maxValue += pad;
+	}
+
+	float span = niceNumber(maxValue - minValue, false);
+	float step = niceNumber(span / ((float)tickCount), true);
+	if (step <= 0.0f)
+		return;
+
+	minValue = floorf(minValue / step) * step;
+	maxValue = ceilf(maxValue / step) * step;
+}
@@ -0,0 +1,62 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GRANGETRACKER
+#define _GRANGETRACKER
+
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+
+/*!
+ * @brief RangeTracker
+ * @details Min and max of a sliding window of values. Each bound is a monotonic deque of
+ * (sequence, value) pairs, so pushing the newest value and popping the oldest are both O(1)
+ * amortized instead of a rescan of the window.
+ */
+
+class RangeTracker
+{
+private:
+	typedef std::pair<unsigned long, float> Entry;
+
+	std::deque<Entry> minQueue;
+	std::deque<Entry> maxQueue;
+	unsigned long headSeq;
+	unsigned long nextSeq;
+
+public:
+	// constructors & destructor
+	RangeTracker();
+	~RangeTracker();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	float getMin() const;
+	float getMax() const;
+
+	// sets
+	void push(float);
+	void pop();
+	void clear();
+
+	static void niceRange(float&, float&, unsigned int);
+	static float niceNumber(float, bool);
+};
+
+#endif
@@ -0,0 +1,247 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "RowIndex.h"
+#include "Bitset.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <math.h>
+
+/*!
+ * @brief key order
+ * @details NaN sorts last in either direction, so missing values stay together at the end
+ */
+static bool keyLess(double a, double b, bool ascending)
+{
+	if (isnan(a))
+		return false;
+	if (isnan(b))
+		return true;
+	return ascending ? (a < b) : (a > b);
+}
+
+static bool keyLess(const std::string& a, const std::string& b, bool ascending)
+{
+	return ascending ? (a < b) : (b < a);
+}
+
+/*!
+ * @brief RowKeyLess
+ * @details orders source rows by their keys
+ */
+template <typename T>
+class RowKeyLess
+{
+public:
+	const T* keys;
+	bool ascending;
+
+	RowKeyLess(const T* newKeys, bool newAscending)
+	{
+		keys = newKeys;
+		ascending = newAscending;
+	}
+
+	bool operator()(unsigned int a, unsigned int b) const
+	{
+		return keyLess(keys[a], keys[b], ascending);
+	}
+};
+
+/*!
+ * @brief RowSortJob
+ * @details sorts one chunk per task, then merges neighbouring runs per task, doubling the run
+ * width each pass until one run is left
+ */
+template <typename T>
+class RowSortJob : public WorkerJob
+{
+public:
+	RowKeyLess<T> keyOrder;
+	std::vector<unsigned int> bounds; // chunk boundaries, chunks + 1
+	unsigned int* src;
+	unsigned int* dst;
+	unsigned int runWidth; // chunks per run, 0 while sorting the chunks
+
+	RowSortJob(const T* keys, bool ascending) : keyOrder(keys, ascending)
+	{
+		src = NULL;
+		dst = NULL;
+		runWidth = 0;
+	}
+
+	virtual void run(unsigned int task)
+	{
+		if (runWidth == 0)
+		{
+			std::stable_sort(src + bounds[task], src + bounds[task + 1], keyOrder);
+			return;
+		}
+
+		const unsigned int chunks = bounds.size() - 1;
+		unsigned int first = task * 2 * runWidth;
+		unsigned int mid = std::min(first + runWidth, chunks);
+		unsigned int last = std::min(first + 2 * runWidth, chunks);
+
+		// ties are taken from the left run, which keeps the merge stable
+		std::merge(src + bounds[first], src + bounds[mid], src + bounds[mid], src + bounds[last],
+				   dst + bounds[first], keyOrder);
+	}
+};
+
+RowIndex::RowIndex()
+{
+	//
+}
+
+RowIndex::~RowIndex()
+{
+	rows.clear();
+}
+
+unsigned int RowIndex::size() const
+{
+	return rows.size();
+}
+
+bool RowIndex::empty() const
+{
+	return rows.empty();
+}
+
+/*!
+ * @brief get a row
+ * @param index the row in the view
+ * @return the row in the table
+ */
+unsigned int RowIndex::get(unsigned int index) const
+{
+	return rows[index];
+}
+
+/*!
+ * @brief reset
+ * @details maps the view straight onto the table
+ * @param rowCount the number of rows in the table
+ */
+void RowIndex::reset(unsigned int rowCount)
+{
+	rows.resize(rowCount);
+	for (unsigned int i = 0; i < rowCount; ++i)
+		rows[i] = i;
+}
+
+/*!
+ * @brief filter
+ * @details drops the rows whose bit is not set, keeping the order of the rest
+ * @param keep one bit per table row
+ */
+void RowIndex::filter(const Bitset& keep)
+{
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < rows.size(); ++i)
+	{
+		if ((rows[i] < keep.size()) && (keep.test(rows[i])))
+			rows[kept++] = rows[i];
+	}
+
+	rows.resize(kept);
+}
+
+/*!
+ * @brief sort
+ * @details stable sort of the view by a numeric key per table row
+ * @param keys one key per table row
+ * @param ascending the order
+ * @param pool the workers to sort with, NULL for the shared pool
+ */
+void RowIndex::sort(const std::vector<double>& keys, bool ascending, WorkerPool* pool)
+{
+	if (keys.empty())
+		return;
+
+	sortRows(&keys[0], ascending, pool);
+}
+
+/*!
+ * @brief sort
+ * @details stable sort of the view by a text key per table row
+ * @param keys one key per table row
+ * @param ascending the order
+ * @param pool the workers to sort with, NULL for the shared pool
+ */
+void RowIndex::sort(const std::vector<std::string>& keys, bool ascending, WorkerPool* pool)
+{
+	if (keys.empty())
+		return;
+
+	sortRows(&keys[0], ascending, pool);
+}
+
+template <typename T>
+void RowIndex::sortRows(const T* keys, bool ascending, WorkerPool* pool)
+{
+	if (rows.size() < 2)
+		return;
+
+	if (!pool)
+		pool = WorkerPool::getSharedPool();
+
+	// one chunk per thread, the caller included
+	unsigned int chunks = pool->size();
+	if (rows.size() / chunks < MIN_TASK_ROWS)
+		chunks = rows.size() / MIN_TASK_ROWS;
+
+	RowSortJob<T> sortJob(keys, ascending);
+	if (chunks < 2)
+	{
+		std::stable_sort(rows.begin(), rows.end(), sortJob.keyOrder);
+		return;
+	}
+
+	for (unsigned int i = 0; i < chunks; ++i)
+		sortJob.bounds.push_back((unsigned int)(((unsigned long long)rows.size() * i) / chunks));
+	sortJob.bounds.push_back(rows.size());
+
+	// sort the chunks in place
+	sortJob.src = &rows[0];
+	pool->run(&sortJob, chunks);
+
+	// merge the runs, swapping buffers each pass
+	std::vector<unsigned int> buffer(rows.size());
+	sortJob.dst = &buffer[0];
+	for (sortJob.runWidth = 1; sortJob.runWidth < chunks; sortJob.runWidth *= 2)
+	{
+		unsigned int merges = (chunks + (2 * sortJob.runWidth) - 1) / (2 * sortJob.runWidth);
+		pool->run(&sortJob, merges);
+
+		unsigned int* swapRows = sortJob.src;
+		sortJob.src = sortJob.dst;
+		sortJob.dst = swapRows;
+	}
+
+	if (sortJob.src != &rows[0])
+		rows.swap(buffer);
+}
+
+/*!
+ * @brief clear
+ * @details empties the view
+ */
+void RowIndex::clear()
+{
+	rows.clear();
+}
@@ -0,0 +1,64 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GROWINDEX
+#define _GROWINDEX
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+class Bitset;
+class WorkerPool;
+
+/*!
+ * @brief RowIndex
+ * @details Maps the rows of a view to the rows of a table, so a view can be sorted and filtered
+ * without moving or copying the table. Sorts are stable merge sorts split across a WorkerPool, so
+ * sorting by one column and then another orders ties by the first.
+ */
+
+class RowIndex
+{
+private:
+	// below this many rows per task the sort stays on the calling thread
+	static const unsigned int MIN_TASK_ROWS = 16384;
+
+	std::vector<unsigned int> rows;
+
+	template <typename T>
+	void sortRows(const T*, bool, WorkerPool*);
+
+public:
+	// constructors & destructor
+	RowIndex();
+	~RowIndex();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	unsigned int get(unsigned int) const;
+
+	// sets
+	void reset(unsigned int);
+	void filter(const Bitset&);
+	void sort(const std::vector<double>&, bool = true, WorkerPool* = NULL);
+	void sort(const std::vector<std::string>&, bool = true, WorkerPool* = NULL);
+	void clear();
+};
+
+#endif
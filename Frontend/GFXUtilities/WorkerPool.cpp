@@ -0,0 +1,198 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "WorkerPool.h"
+#include <unistd.h>
+
+pthread_once_t WorkerPool::sharedOnce = PTHREAD_ONCE_INIT;
+WorkerPool* WorkerPool::sharedPool = NULL;
+
+WorkerJob::~WorkerJob()
+{
+	//
+}
+
+/*!
+ * @brief WorkerPool constructor
+ * @param threadCount the number of worker threads, 0 uses one per core besides the caller
+ */
+WorkerPool::WorkerPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = (cores > 1) ? (unsigned int)(cores - 1) : 0;
+	}
+
+	poolMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(poolMutex, NULL);
+	runMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(runMutex, NULL);
+	startCond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+	pthread_cond_init(startCond, NULL);
+	doneCond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+	pthread_cond_init(doneCond, NULL);
+
+	currentJob = NULL;
+	taskCount = 0;
+	nextTask = 0;
+	activeWorkers = 0;
+	generation = 0;
+	stopping = false;
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		pthread_t worker;
+		if (pthread_create(&worker, NULL, workerLoop, this) == 0)
+			threads.push_back(worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	pthread_mutex_lock(poolMutex);
+	stopping = true;
+	pthread_cond_broadcast(startCond);
+	pthread_mutex_unlock(poolMutex);
+
+	for (unsigned int i = 0; i < threads.size(); ++i)
+		pthread_join(threads[i], NULL);
+	threads.clear();
+
+	pthread_cond_destroy(doneCond);
+	free(doneCond);
+	pthread_cond_destroy(startCond);
+	free(startCond);
+	pthread_mutex_destroy(runMutex);
+	free(runMutex);
+	pthread_mutex_destroy(poolMutex);
+	free(poolMutex);
+}
+
+/*!
+ * @brief size
+ * @return the number of threads that run tasks, including the caller of run
+ */
+unsigned int WorkerPool::size() const
+{
+	return threads.size() + 1;
+}
+
+void WorkerPool::createSharedPool()
+{
+	sharedPool = new WorkerPool();
+}
+
+/*!
+ * @brief get the shared pool
+ * @details the process wide pool, created on first use
+ * @return the shared pool
+ */
+WorkerPool* WorkerPool::getSharedPool()
+{
+	pthread_once(&sharedOnce, createSharedPool);
+	return sharedPool;
+}
+
+void* WorkerPool::workerLoop(void* arg)
+{
+	WorkerPool* pool = (WorkerPool*)arg;
+	unsigned int seenGeneration = 0;
+
+	while (true)
+	{
+		pthread_mutex_lock(pool->poolMutex);
+		while ((!pool->stopping) && (pool->generation == seenGeneration))
+			pthread_cond_wait(pool->startCond, pool->poolMutex);
+
+		if (pool->stopping)
+		{
+			pthread_mutex_unlock(pool->poolMutex);
+			break;
+		}
+
+		seenGeneration = pool->generation;
+		WorkerJob* job = pool->currentJob;
+		pthread_mutex_unlock(pool->poolMutex);
+
+		pool->runTasks(job);
+
+		pthread_mutex_lock(pool->poolMutex);
+		--pool->activeWorkers;
+		if (pool->activeWorkers == 0)
+			pthread_cond_signal(pool->doneCond);
+		pthread_mutex_unlock(pool->poolMutex);
+	}
+
+	return NULL;
+}
+
+void WorkerPool::runTasks(WorkerJob* job)
+{
+	if (!job)
+		return;
+
+	while (true)
+	{
+		unsigned int task = __sync_fetch_and_add(&nextTask, 1);
+		if (task >= taskCount)
+			break;
+
+		job->run(task);
+	}
+}
+
+/*!
+ * @brief run
+ * @details runs every task of a job across the pool and waits for them
+ * @param job the job
+ * @param newTaskCount the number of tasks, run gets the indices [0, newTaskCount)
+ */
+void WorkerPool::run(WorkerJob* job, unsigned int newTaskCount)
+{
+	if ((!job) || (newTaskCount == 0))
+		return;
+
+	// not worth waking anybody up
+	if ((newTaskCount == 1) || (threads.empty()))
+	{
+		for (unsigned int i = 0; i < newTaskCount; ++i)
+			job->run(i);
+		return;
+	}
+
+	pthread_mutex_lock(runMutex);
+
+	pthread_mutex_lock(poolMutex);
+	currentJob = job;
+	taskCount = newTaskCount;
+	nextTask = 0;
+	activeWorkers = threads.size();
+	++generation;
+	pthread_cond_broadcast(startCond);
+	pthread_mutex_unlock(poolMutex);
+
+	// the caller works too
+	runTasks(job);
+
+	pthread_mutex_lock(poolMutex);
+	while (activeWorkers > 0)
+		pthread_cond_wait(doneCond, poolMutex);
+	currentJob = NULL;
+	pthread_mutex_unlock(poolMutex);
+
+	pthread_mutex_unlock(runMutex);
+}
@@ -0,0 +1,81 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GWORKERPOOL
+#define _GWORKERPOOL
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief WorkerJob
+ * @details A unit of parallel work split into numbered tasks. run is called once per task index,
+ * from any pool thread, and must only touch the state that belongs to that task.
+ */
+
+class WorkerJob
+{
+public:
+	virtual ~WorkerJob();
+	virtual void run(unsigned int) = 0;
+};
+
+/*!
+ * @brief WorkerPool
+ * @details Persistent worker threads for data-parallel render work. run hands the tasks of one
+ * job to the workers and the calling thread, and returns once every task has finished. Jobs from
+ * different threads are run one at a time.
+ */
+
+class WorkerPool
+{
+private:
+	std::vector<pthread_t> threads;
+	pthread_mutex_t* poolMutex;
+	pthread_mutex_t* runMutex;
+	pthread_cond_t* startCond;
+	pthread_cond_t* doneCond;
+
+	WorkerJob* currentJob;
+	unsigned int taskCount;
+	volatile unsigned int nextTask;
+	unsigned int activeWorkers;
+	unsigned int generation;
+	bool stopping;
+
+	static pthread_once_t sharedOnce;
+	static WorkerPool* sharedPool;
+
+	static void* workerLoop(void*);
+	static void createSharedPool();
+	void runTasks(WorkerJob*);
+
+public:
+	// constructors & destructor
+	WorkerPool(unsigned int = 0);
+	~WorkerPool();
+
+	// gets
+	unsigned int size() const;
+	static WorkerPool* getSharedPool();
+
+	// run
+	void run(WorkerJob*, unsigned int);
+};
+
+#endif
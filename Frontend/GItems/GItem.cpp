@@ -21,11 +21,19 @@
 #include "GPanel.h"
 #include "RUColors.h"
 
+bool GItem::flattening = false;
+unsigned int GItem::redrawCount = 0;
+
 GItem::GItem()
 {
 	id = 0;
 	name = "";
 	background = NULL;
+	overlayPanel = NULL;
+	layer = NULL;
+	layerReady = false;
+	staticFrames = 0;
+	layerSignature = 0;
 	zindex = -2;
 
 	// Ready
@@ -38,6 +46,11 @@ GItem::GItem(int newX, int newY, int newWidth, int newHeight)
 	id = 0;
 	name = "";
 	background = NULL;
+	overlayPanel = NULL;
+	layer = NULL;
+	layerReady = false;
+	staticFrames = 0;
+	layerSignature = 0;
 	zindex = -2;
 
 	// Ready
@@ -47,7 +60,12 @@ GItem::GItem(int newX, int newY, int newWidth, int newHeight)
 
 GItem::~GItem()
 {
-	//
+	if (overlayPanel)
+		overlayPanel->removeOverlay(this, false);
+
+	if (layer)
+		SDL_DestroyTexture(layer);
+	layer = NULL;
 }
 
 int GItem::getID() const
@@ -94,11 +112,52 @@ SDL_Texture* GItem::getBackground()
 	return background;
 }
 
+/*!
+ * @brief release textures
+ * @details frees the textures of the item and its subitems, e.g. while it is hidden. They are
+ * drawn again on the next render.
+ */
+void GItem::releaseTextures()
+{
+	if (background)
+		SDL_DestroyTexture(background);
+	background = NULL;
+	drawUpdate = true;
+
+	if (layer)
+		SDL_DestroyTexture(layer);
+	layer = NULL;
+	layerReady = false;
+	staticFrames = 0;
+
+	for (unsigned int i = 0; i < subitems.size(); ++i)
+	{
+		if (subitems[i])
+			subitems[i]->releaseTextures();
+	}
+}
+
 std::vector<GItem*> GItem::getItems() const
 {
 	return subitems;
 }
 
+GPanel* GItem::getOverlayPanel() const
+{
+	return overlayPanel;
+}
+
+/*!
+ * @brief is deferred to the overlay
+ * @details overlays keep their place in the item tree, but are drawn and get their events in the
+ * overlay pass of their panel instead of with their parent
+ * @return true if the item is an overlay and its panel is in the base pass
+ */
+bool GItem::isDeferredToOverlay() const
+{
+	return (overlayPanel) && (!overlayPanel->isOverlayPass());
+}
+
 void GItem::setID(int newID)
 {
 	id = newID;
@@ -130,6 +189,223 @@ void GItem::setZIndex(int newZIndex)
 	zindex = newZIndex;
 }
 
+/*!
+ * @brief is the subtree clean
+ * @details walks the shown subitems. A flattened layer holds only while none of them within the
+ * bounds needs a draw update, and none of them moves, shows or hides.
+ * @param bounds the rect the layer covers
+ * @param signature accumulates the visibility and location of every subitem
+ * @return true if the subtree can be drawn from a cached layer
+ */
+bool GItem::isSubtreeClean(const SDL_Rect& bounds, unsigned int& signature) const
+{
+	for (unsigned int i = 0; i < subitems.size(); ++i)
+	{
+		const GItem* cItem = subitems[i];
+		if (!cItem)
+			continue;
+
+		bool shown = (cItem->isVisible()) && (!cItem->isDeferredToOverlay());
+		signature = signature * 31 + shown;
+		if (!shown)
+			continue;
+
+		SDL_Rect cRect = cItem->getLocationRect();
+		signature = signature * 31 + (cRect.x - bounds.x);
+		signature = signature * 31 + (cRect.y - bounds.y);
+		signature = signature * 31 + cRect.w;
+		signature = signature * 31 + cRect.h;
+
+		// Clipped out, it does not draw into the layer
+		SDL_Rect cClip = cItem->getClipRect();
+		bool culled = !SDL_HasIntersection(&cClip, &bounds);
+		if ((!culled) && (cItem->getDrawUpdateRequired()))
+			return false;
+
+		if (!cItem->isSubtreeClean(bounds, signature))
+			return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief is flattened
+ * @return true if the subtree is drawn from one cached layer
+ */
+bool GItem::isFlattened() const
+{
+	return layerReady;
+}
+
+/*!
+ * @brief update the layer state
+ * @details called once a frame. Any change below demotes the flattened layer, otherwise the static
+ * frames are counted up to FLATTEN_FRAMES.
+ * @return true if the layer can be drawn as is
+ */
+bool GItem::updateLayerState()
+{
+	unsigned int signature = 0;
+	SDL_Rect bounds = getLocationRect();
+	SDL_Rect clip = getClipRect();
+	bool clean = (!getDrawUpdateRequired()) && (isSubtreeClean(bounds, signature));
+
+	// The layer would cut off what is drawn outside the location
+	if (!SDL_RectEquals(&bounds, &clip))
+		clean = false;
+
+	if ((!clean) || (signature != layerSignature))
+	{
+		layerSignature = signature;
+		layerReady = false;
+		staticFrames = 0;
+	}
+	else if (staticFrames < FLATTEN_FRAMES)
+		++staticFrames;
+
+	return layerReady;
+}
+
+/*!
+ * @brief flatten the subtree
+ * @details once the subtree has been static for FLATTEN_FRAMES, renders the background and every
+ * subitem into one cached layer. Subitems still draw at their absolute location, the viewport
+ * moves them into the layer.
+ * @param renderer the renderer
+ * @param backwards draw the subitems last to first, like GPanel
+ * @return true if the layer is ready
+ */
+bool GItem::flattenLayer(SDL_Renderer* renderer, bool backwards)
+{
+	if ((staticFrames < FLATTEN_FRAMES) || (subitems.empty()))
+		return false;
+
+	// Nested items are inside this layer already
+	if (flattening)
+		return false;
+
+	if (!background)
+		return false;
+
+	// Resize
+	int layerWidth = 0;
+	int layerHeight = 0;
+	if (layer)
+		SDL_QueryTexture(layer, NULL, NULL, &layerWidth, &layerHeight);
+	if ((layerWidth != width) || (layerHeight != height))
+	{
+		if (layer)
+			SDL_DestroyTexture(layer);
+		layer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+								  width, height);
+		if (!layer)
+			return false;
+		SDL_SetTextureBlendMode(layer, SDL_BLENDMODE_BLEND);
+	}
+
+	SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, layer);
+
+	SDL_Rect viewport;
+	viewport.x = -getX();
+	viewport.y = -getY();
+	viewport.w = getX() + width;
+	viewport.h = getY() + height;
+	SDL_RenderSetViewport(renderer, &viewport);
+
+	// Clipped in the same coordinates as the draw calls
+	SDL_Rect clip = getClipRect();
+	SDL_RenderSetClipRect(renderer, &clip);
+
+	// The background as is, alpha included
+	SDL_Rect dRect = getLocationRect();
+	SDL_SetTextureBlendMode(background, SDL_BLENDMODE_NONE);
+	SDL_RenderCopy(renderer, background, NULL, &dRect);
+	SDL_SetTextureBlendMode(background, SDL_BLENDMODE_BLEND);
+
+	unsigned int prevRedrawCount = redrawCount;
+	flattening = true;
+	drawSubItems(renderer, backwards);
+	flattening = false;
+
+	// Also resets the viewport and the clip
+	SDL_SetRenderTarget(renderer, prevTarget);
+
+	// A subitem changed while the layer was drawn, e.g. from a producer thread. Use the layer
+	// this frame, but build it again once the subtree settles.
+	layerReady = (redrawCount == prevRedrawCount);
+	if (!layerReady)
+		staticFrames = 0;
+	return true;
+}
+
+void GItem::drawLayer(SDL_Renderer* renderer)
+{
+	if (!layer)
+		return;
+
+	SDL_Rect dRect = getLocationRect();
+	SDL_RenderCopy(renderer, layer, NULL, &dRect);
+}
+
+/*!
+ * @brief draw the subitems
+ * @details clips them to the clip rect of this item, within the current clip. Subitems outside of
+ * it cull themselves.
+ * @param renderer the renderer
+ * @param backwards draw the subitems last to first, like GPanel
+ */
+void GItem::drawSubItems(SDL_Renderer* renderer, bool backwards)
+{
+	if (subitems.empty())
+		return;
+
+	SDL_Rect prevClip;
+	bool clipped = (SDL_RenderIsClipEnabled(renderer) == SDL_TRUE);
+	SDL_RenderGetClipRect(renderer, &prevClip);
+
+	SDL_Rect clip = getClipRect();
+	if ((clipped) && (!SDL_IntersectRect(&prevClip, &clip, &clip)))
+		return;
+
+	SDL_RenderSetClipRect(renderer, &clip);
+	for (unsigned int i = 0; i < subitems.size(); ++i)
+		subitems[backwards ? subitems.size() - 1 - i : i]->updateBackgroundHelper(renderer);
+	SDL_RenderSetClipRect(renderer, clipped ? &prevClip : NULL);
+}
+
+/*!
+ * @brief is clipped out
+ * @param renderer the renderer
+ * @return true if nothing of the item or its subtree would show within the current clip
+ */
+bool GItem::isClippedOut(SDL_Renderer* renderer) const
+{
+	if (SDL_RenderIsClipEnabled(renderer) != SDL_TRUE)
+		return false;
+
+	SDL_Rect clip;
+	SDL_RenderGetClipRect(renderer, &clip);
+	SDL_Rect bounds = getClipRect();
+	return !SDL_HasIntersection(&clip, &bounds);
+}
+
+/*!
+ * @brief get the clip rect
+ * @details subitems are clipped to it. Override it for items that draw outside their location.
+ * @return the location of the item by default
+ */
+SDL_Rect GItem::getClipRect() const
+{
+	return getLocationRect();
+}
+
+void GItem::setOverlayPanel(GPanel* newOverlayPanel)
+{
+	overlayPanel = newOverlayPanel;
+}
+
 /*void GItem::setBGImageFromLocation(const std::string& newBGImageLocation)
 {
 	if (!bgComp)
@@ -226,6 +502,9 @@ EventTracker* GItem::processEvents(GPanel* parentPanel, SDL_Event event, int mou
 	if (!visible)
 		return eventsStatus;
 
+	if (isDeferredToOverlay())
+		return eventsStatus;
+
 	//
 	processSubItemEvents(eventsStatus, parentPanel, event, mouseX, mouseY);
 
@@ -55,13 +55,28 @@ protected:
 	std::string name;
 	SDL_Texture* background;
 	std::vector<GItem*> subitems;
+	GPanel* overlayPanel;
+
+	// flattened subtree
+	static bool flattening;
+	static unsigned int redrawCount; // backgrounds rendered so far
+	SDL_Texture* layer;
+	bool layerReady;
+	unsigned int staticFrames;
+	unsigned int layerSignature;
 
 	// render
 	virtual void updateBackground(SDL_Renderer*) = 0;
+	bool updateLayerState();
+	bool flattenLayer(SDL_Renderer*, bool = false);
+	void drawLayer(SDL_Renderer*);
+	void drawSubItems(SDL_Renderer*, bool = false);
+	bool isClippedOut(SDL_Renderer*) const;
 
 public:
 	static const int Z_FRONT = -1;
 	static const int Z_BACK = -2;
+	static const unsigned int FLATTEN_FRAMES = 30;
 
 	GItem();
 	GItem(int, int, int, int);
@@ -75,6 +90,11 @@ public:
 	int getZIndex() const;
 	SDL_Texture* getBackground();
 	std::vector<GItem*> getItems() const;
+	GPanel* getOverlayPanel() const;
+	bool isDeferredToOverlay() const;
+	bool isSubtreeClean(const SDL_Rect&, unsigned int&) const;
+	bool isFlattened() const;
+	virtual SDL_Rect getClipRect() const;
 
 	// sets
 	void setID(int);
@@ -82,6 +102,7 @@ public:
 	void setWidth(int);
 	void setHeight(int);
 	void setZIndex(int);
+	void setOverlayPanel(GPanel*);
 
 	// subcomps
 	virtual void addSubItem(GItem*, int = Z_FRONT);
@@ -93,6 +114,7 @@ public:
 
 	// render
 	virtual void updateBackgroundHelper(SDL_Renderer*) = 0;
+	virtual void releaseTextures();
 
 	// event functions
 	EventTracker* processEvents(GPanel*, SDL_Event, int, int);
@@ -32,9 +32,22 @@ GPanel::GPanel(const std::string& newName, int newWidth, int newHeight)
 	width = newWidth;
 	height = newHeight;
 	focus = false;
+	overlayPass = false;
 	setBGColor(RUColors::DEFAULT_COLOR_BACKGROUND);
 }
 
+GPanel::~GPanel()
+{
+	for (unsigned int i = 0; i < overlays.size(); ++i)
+		overlays[i]->setOverlayPanel(NULL);
+	overlays.clear();
+
+	// the owned overlays that are still open
+	closedOverlays.insert(closedOverlays.end(), ownedOverlays.begin(), ownedOverlays.end());
+	ownedOverlays.clear();
+	deleteClosedOverlays();
+}
+
 void GPanel::onShow()
 {
 	focus = true;
@@ -103,6 +116,142 @@ void GPanel::addSubItem(GItem* newItem, int newZIndex)
 	drawUpdate = true;
 }
 
+/*!
+ * @brief add an overlay
+ * @details overlays are drawn above every subitem and get the events first. Adding, moving or
+ * removing one does not redraw the base layer. An item that is also a subitem keeps its place in
+ * the tree, but is skipped by its parent while it is an overlay.
+ * @param newItem the popup, e.g. a message box or an open dropdown
+ * @param owned true if the panel deletes the item once it is removed
+ */
+void GPanel::addOverlay(GItem* newItem, bool owned)
+{
+	if (!newItem)
+		return;
+
+	if (newItem->getOverlayPanel() == this)
+		return;
+
+	if (newItem->getOverlayPanel())
+		newItem->getOverlayPanel()->removeOverlay(newItem, false);
+
+	newItem->setOverlayPanel(this);
+	overlays.push_back(newItem);
+	if (owned)
+		ownedOverlays.push_back(newItem);
+}
+
+/*!
+ * @brief remove an overlay
+ * @details the item is drawn with its parent again, if it has one. An owned overlay is deleted at
+ * the end of the event pass, since it usually removes itself from its own click handler.
+ * @param oldItem the overlay to remove
+ * @param deleteOwned false if the item is already being deleted
+ */
+void GPanel::removeOverlay(GItem* oldItem, bool deleteOwned)
+{
+	for (unsigned int i = 0; i < overlays.size(); ++i)
+	{
+		if (overlays[i] == oldItem)
+		{
+			overlays.erase(overlays.begin() + i);
+			oldItem->setOverlayPanel(NULL);
+			break;
+		}
+	}
+
+	for (unsigned int i = 0; i < ownedOverlays.size(); ++i)
+	{
+		if (ownedOverlays[i] == oldItem)
+		{
+			ownedOverlays.erase(ownedOverlays.begin() + i);
+			if (deleteOwned)
+				closedOverlays.push_back(oldItem);
+			break;
+		}
+	}
+}
+
+/*!
+ * @brief subtree check
+ * @param cItem the root of the subtree
+ * @param target the item to look for
+ * @return true if the target is the root or one of its subitems
+ */
+static bool subtreeContains(const GItem* cItem, const GItem* target)
+{
+	if (!cItem)
+		return false;
+
+	if (cItem == target)
+		return true;
+
+	std::vector<GItem*> cSubItems = cItem->getItems();
+	for (unsigned int i = 0; i < cSubItems.size(); ++i)
+	{
+		if (subtreeContains(cSubItems[i], target))
+			return true;
+	}
+
+	return false;
+}
+
+/*!
+ * @brief delete the closed overlays
+ * @details frees the owned overlays removed since the last call. Only safe outside their events.
+ */
+void GPanel::deleteClosedOverlays()
+{
+	std::vector<GItem*> cClosed;
+	cClosed.swap(closedOverlays);
+	for (unsigned int i = 0; i < cClosed.size(); ++i)
+	{
+		// e.g. the input box of a message box
+		if ((Graphics::focusedItem) && (subtreeContains(cClosed[i], Graphics::focusedItem)))
+			Graphics::focusedItem = NULL;
+
+		delete cClosed[i];
+	}
+}
+
+const std::vector<GItem*>& GPanel::getOverlays() const
+{
+	return overlays;
+}
+
+bool GPanel::isOverlayPass() const
+{
+	return overlayPass;
+}
+
+/*!
+ * @brief overlay hit test
+ * @details checks the item and its visible subitems, as an open dropdown list hangs below the
+ * dropdown itself
+ * @param cItem the overlay
+ * @param mouseX the mouse x
+ * @param mouseY the mouse y
+ * @return true if the mouse is over the item
+ */
+static bool overlayContains(const GItem* cItem, int mouseX, int mouseY)
+{
+	if ((!cItem) || (!cItem->isVisible()))
+		return false;
+
+	if ((mouseX >= cItem->getX()) && (mouseX < cItem->getX() + cItem->getWidth()) &&
+		(mouseY >= cItem->getY()) && (mouseY < cItem->getY() + cItem->getHeight()))
+		return true;
+
+	std::vector<GItem*> cSubItems = cItem->getItems();
+	for (unsigned int i = 0; i < cSubItems.size(); ++i)
+	{
+		if (overlayContains(cSubItems[i], mouseX, mouseY))
+			return true;
+	}
+
+	return false;
+}
+
 void GPanel::calculateSubItemPositions(std::pair<int, int> parentOffset)
 {
 	// We just pass in manual X/Y on subitem creation
@@ -124,7 +273,34 @@ void GPanel::processSubItemEvents(EventTracker* eventsStatus, GPanel* parentPane
 		return;
 
 	bool hovered = false;
-	for (unsigned int i = 0; i < subitems.size(); ++i)
+	bool covered = false;
+
+	// Overlays first, topmost first. Copied since a popup may close itself.
+	std::vector<GItem*> cOverlays = overlays;
+	overlayPass = true;
+	for (int i = cOverlays.size() - 1; i >= 0; --i)
+	{
+		GItem* cItem = cOverlays[i];
+		if ((!cItem) || (cItem->getOverlayPanel() != this))
+			continue;
+
+		bool hit = overlayContains(cItem, mouseX, mouseY);
+		EventTracker* eventsStatus = cItem->processEvents(this, event, mouseX, mouseY);
+		if (eventsStatus->hovered)
+			hovered = true;
+		delete eventsStatus;
+
+		// Clicks and scrolls do not go through a popup
+		if ((hit) && ((event.type == SDL_MOUSEBUTTONDOWN) || (event.type == SDL_MOUSEBUTTONUP) ||
+					  (event.type == SDL_MOUSEWHEEL)))
+		{
+			covered = true;
+			break;
+		}
+	}
+	overlayPass = false;
+
+	for (unsigned int i = 0; (!covered) && (i < subitems.size()); ++i)
 	{
 		GItem* cItem = subitems[i];
 		if (!cItem)
@@ -136,6 +312,9 @@ void GPanel::processSubItemEvents(EventTracker* eventsStatus, GPanel* parentPane
 		delete eventsStatus;
 	}
 
+	// every handler has returned, so popups that closed themselves can go
+	deleteClosedOverlays();
+
 	if (!hovered)
 	{
 		// Set the default cursor
@@ -158,6 +337,7 @@ void GPanel::updateBackgroundHelper(SDL_Renderer* renderer)
 	if (!((width > 0) && (height > 0)))
 		return;
 
+	bool flattened = updateLayerState();
 	if (getDrawUpdateRequired())
 	{
 		drawUpdate = false;
@@ -192,6 +372,14 @@ void GPanel::updateBackgroundHelper(SDL_Renderer* renderer)
 		SDL_SetRenderTarget(renderer, NULL);
 	}
 
+	// A static panel is one copy
+	if ((flattened) || (flattenLayer(renderer, true)))
+	{
+		drawLayer(renderer);
+		drawOverlays(renderer);
+		return;
+	}
+
 	// draw the background
 	SDL_Rect dRect = getLocationRect();
 	dRect.x = getX();
@@ -226,8 +414,18 @@ void GPanel::updateBackgroundHelper(SDL_Renderer* renderer)
 	}*/
 
 	// Go backwards because of dropdowns
-	for (int i = subitems.size() - 1; i >= 0; --i)
-		subitems[i]->updateBackgroundHelper(renderer);
+	drawSubItems(renderer, true);
+
+	drawOverlays(renderer);
+}
+
+void GPanel::drawOverlays(SDL_Renderer* renderer)
+{
+	// The popups go on top, from their own textures
+	overlayPass = true;
+	for (unsigned int i = 0; i < overlays.size(); ++i)
+		overlays[i]->updateBackgroundHelper(renderer);
+	overlayPass = false;
 }
 
 void GPanel::updateBackground(SDL_Renderer* renderer)
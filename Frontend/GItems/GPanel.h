@@ -36,6 +36,13 @@ class GPanel : public GItem
 {
 
 protected:
+	std::vector<GItem*> overlays;
+	bool overlayPass;
+
+	// overlays the panel deletes once they are removed, e.g. message boxes
+	std::vector<GItem*> ownedOverlays;
+	std::vector<GItem*> closedOverlays;
+
 	// Lifetime (virtual) functions
 	virtual void onStart() = 0;
 	virtual void onShow();
@@ -43,13 +50,22 @@ protected:
 
 	// render
 	virtual void updateBackground(SDL_Renderer* renderer);
+	void drawOverlays(SDL_Renderer*);
+	void deleteClosedOverlays();
 
 public:
 	GPanel(const std::string&, int, int);
+	virtual ~GPanel();
 
 	virtual void addSubItem(GItem*, int = Z_FRONT);
 	virtual void calculateSubItemPositions(std::pair<int, int>);
 
+	// overlays
+	void addOverlay(GItem*, bool = false);
+	void removeOverlay(GItem*, bool = true);
+	const std::vector<GItem*>& getOverlays() const;
+	bool isOverlayPass() const;
+
 	// events
 	void show();
 	void hide();
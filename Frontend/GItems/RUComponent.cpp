@@ -17,6 +17,7 @@
 
 #include "RUComponent.h"
 #include "../GFXUtilities/EventTracker.h"
+#include "GPanel.h"
 #include "Mini/RUBackgroundComponent.h"
 #include "Mini/RUBorderComponent.h"
 
@@ -81,6 +82,19 @@ void RUComponent::updateBackgroundHelper(SDL_Renderer* renderer)
 	if (!((width > 0) && (height > 0)))
 		return;
 
+	if (isDeferredToOverlay())
+		return;
+
+	// Nothing of it would show
+	if (isClippedOut(renderer))
+		return;
+
+	if (updateLayerState())
+	{
+		drawLayer(renderer);
+		return;
+	}
+
 	if (getDrawUpdateRequired())
 	{
 		drawUpdate = false;
@@ -97,6 +111,15 @@ void RUComponent::updateBackgroundHelper(SDL_Renderer* renderer)
 			return;
 		}
 
+		// Inside a flattened layer the target is the layer, not the window
+		SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer);
+		SDL_Rect prevViewport;
+		SDL_Rect prevClip;
+		bool clipped = (SDL_RenderIsClipEnabled(renderer) == SDL_TRUE);
+		SDL_RenderGetViewport(renderer, &prevViewport);
+		SDL_RenderGetClipRect(renderer, &prevClip);
+		++redrawCount;
+
 		// Assign the background as the render target and reset the background
 		SDL_SetRenderTarget(renderer, background);
 		SDL_RenderClear(renderer);
@@ -111,8 +134,17 @@ void RUComponent::updateBackgroundHelper(SDL_Renderer* renderer)
 		// draw the border
 		updateBorderBackground(renderer);
 
-		// Reset the render target to default
-		SDL_SetRenderTarget(renderer, NULL);
+		// Restore the render target
+		SDL_SetRenderTarget(renderer, prevTarget);
+		SDL_RenderSetViewport(renderer, &prevViewport);
+		SDL_RenderSetClipRect(renderer, clipped ? &prevClip : NULL);
+	}
+
+	// Static for long enough, draw it with one copy from now on
+	if (flattenLayer(renderer))
+	{
+		drawLayer(renderer);
+		return;
 	}
 
 	// draw the background
@@ -123,8 +155,7 @@ void RUComponent::updateBackgroundHelper(SDL_Renderer* renderer)
 	if (geBackground)
 		SDL_RenderCopy(renderer, geBackground, NULL, &dRect);
 
-	for (unsigned int i = 0; i < subitems.size(); ++i)
-		subitems[i]->updateBackgroundHelper(renderer);
+	drawSubItems(renderer);
 }
 
 void RUComponent::hover()
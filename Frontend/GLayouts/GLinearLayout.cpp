@@ -131,6 +131,12 @@ void GLinearLayout::updateBackgroundHelper(SDL_Renderer* renderer)
 	if (!visible)
 		return;
 
+	if (isDeferredToOverlay())
+		return;
+
+	// Nothing of its own to draw
+	drawUpdate = false;
+
 	// Go backwards because of dropdowns
 	for (unsigned int i = subitems.size(); i > 0; --i)
 	{
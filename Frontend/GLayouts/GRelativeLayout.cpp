@@ -44,7 +44,8 @@ void GRelativeLayout::updateBackground(SDL_Renderer* renderer)
 
 void GRelativeLayout::updateBackgroundHelper(SDL_Renderer* renderer)
 {
-	//
+	// Nothing of its own to draw
+	drawUpdate = false;
 }
 
 std::string GRelativeLayout::getType() const
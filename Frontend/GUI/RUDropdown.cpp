@@ -15,7 +15,9 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RUDropdown.h"
+#include "../GItems/GPanel.h"
 #include "../GItems/RUColors.h"
+#include "../Graphics/graphics.h"
 #include "RUImageComponent.h"
 #include "RUListbox.h"
 #include "RUScrollbar.h"
@@ -81,10 +83,21 @@ unsigned int RUDropdown::getOptionsShown() const
 	return lbItems->getOptionsShown();
 }
 
+/*!
+ * @brief get the list rows
+ * @return the rows of the open list, the search box included
+ */
+unsigned int RUDropdown::getListRows() const
+{
+	if (lbItems->getSearchEnabled())
+		return getOptionsShown() + 1;
+	return getOptionsShown();
+}
+
 unsigned int RUDropdown::getSelectedIndex()
 {
 	if (lbItems->size() > 0)
-		selectedIndex = lbItems->getItemsSelected()[0];
+		selectedIndex = lbItems->getFirstSelected();
 	else
 		selectedIndex = -1;
 
@@ -99,16 +112,28 @@ std::string RUDropdown::getSelectedText() const
 	return selectedLabel->getText();
 }
 
+/*!
+ * @brief open or close the list
+ * @details the open dropdown is an overlay of the focused panel, so the list is drawn above and
+ * clicked before the items it covers
+ */
 void RUDropdown::toggleOpen()
 {
 	open = !open;
 	lbItems->setVisible(open);
+	if (!open)
+		lbItems->setSearchText("");
 	if (open)
 		arrowLocation = "resources/gui/Scrollbar/ArrowUp.bmp";
 	else
 		arrowLocation = "resources/gui/Scrollbar/ArrowDown.bmp";
 	arrow->setBGImageFromLocation(arrowLocation);
 
+	if ((open) && (Graphics::focusedPanel))
+		Graphics::focusedPanel->addOverlay(this);
+	else if ((!open) && (getOverlayPanel()))
+		getOverlayPanel()->removeOverlay(this);
+
 	drawUpdate = true;
 }
 
@@ -150,7 +175,7 @@ void RUDropdown::setHeight(int newHeight)
 
 	// update the listbox
 	lbItems->setMarginY(height);
-	lbItems->setHeight(height * getOptionsShown());
+	lbItems->setHeight(height * getListRows());
 
 	drawUpdate = true;
 }
@@ -158,7 +183,7 @@ void RUDropdown::setHeight(int newHeight)
 void RUDropdown::setOptionsShown(unsigned int newOptionsShown)
 {
 	lbItems->setOptionsShown(newOptionsShown);
-	lbItems->setHeight(height * getOptionsShown());
+	lbItems->setHeight(height * getListRows());
 
 	drawUpdate = true;
 }
@@ -171,7 +196,7 @@ void RUDropdown::setSelectedIndex(unsigned int newIndex)
 		{
 			selectedIndex = newIndex;
 			lbItems->addSelection(selectedIndex);
-			selectedLabel->setText(lbItems->items[selectedIndex]->getText());
+			selectedLabel->setText(lbItems->getOption(selectedIndex));
 		}
 		else
 			selectedIndex = -1;
@@ -191,13 +216,51 @@ void RUDropdown::addOption(std::string newItemText)
 	if ((!lbItems->getMultiSelect()) && (lbItems->size() == 1))
 	{
 		selectedIndex = 0;
-		selectedLabel->setText(lbItems->items[selectedIndex]->getText());
+		selectedLabel->setText(lbItems->getOption(selectedIndex));
+		lbItems->addSelection(selectedIndex);
+	}
+
+	drawUpdate = true;
+}
+
+/*!
+ * @brief add options
+ * @details appends many options at once, selecting the first if none were there
+ * @param newOptions the option texts
+ */
+void RUDropdown::addOptions(const std::vector<std::string>& newOptions)
+{
+	if (newOptions.empty())
+		return;
+
+	bool wasEmpty = (lbItems->size() == 0);
+	lbItems->addOptions(newOptions);
+
+	// select the first item
+	if ((!lbItems->getMultiSelect()) && (wasEmpty))
+	{
+		selectedIndex = 0;
+		selectedLabel->setText(lbItems->getOption(selectedIndex));
 		lbItems->addSelection(selectedIndex);
 	}
 
 	drawUpdate = true;
 }
 
+/*!
+ * @brief enable the search
+ * @details shows a search box at the top of the open list that narrows the options as it is typed
+ * in
+ * @param enable whether to show the search box
+ */
+void RUDropdown::setSearchEnabled(bool enable)
+{
+	lbItems->setSearchEnabled(enable);
+	lbItems->setHeight(height * getListRows());
+
+	drawUpdate = true;
+}
+
 void RUDropdown::clearOptions()
 {
 	if (open)
@@ -213,6 +276,22 @@ void RUDropdown::updateBackground(SDL_Renderer* renderer)
 	//
 }
 
+/*!
+ * @brief get the clip rect
+ * @details includes the open list, it hangs below the dropdown
+ */
+SDL_Rect RUDropdown::getClipRect() const
+{
+	SDL_Rect clip = getLocationRect();
+	if ((lbItems) && (lbItems->isVisible()))
+	{
+		SDL_Rect listRect = lbItems->getLocationRect();
+		SDL_UnionRect(&clip, &listRect, &clip);
+	}
+
+	return clip;
+}
+
 void RUDropdown::setOptionChangedListener(void (GPanel::*f)(int))
 {
 	OptionChangedListener = f;
@@ -231,13 +310,17 @@ void RUDropdown::onMouseDown(GPanel* cPanel, int eventX, int eventY)
 	}
 	else
 	{
+		// search box click
+		if (eventY - getHeight() < lbItems->getSearchHeight())
+			return;
+
 		// not scrollbar click
 		if (!((eventX >= lbItems->scrollbar->getMarginX()) && (eventX < getWidth())))
 		{
-			if (getSelectedIndex() >= lbItems->items.size())
+			if (getSelectedIndex() >= lbItems->size())
 				return;
 
-			selectedLabel->setText(lbItems->items[getSelectedIndex()]->getText());
+			selectedLabel->setText(lbItems->getOption(getSelectedIndex()));
 			toggleOpen();
 		}
 	}
@@ -264,10 +347,10 @@ void RUDropdown::onMouseDown(GPanel* cPanel, int eventX, int eventY)
 			// not scrollbar click
 			if(!(lbItems->scrollbar->isVisible() && (eventX >= lbItems->scrollbar->getMarginX())))
 			{
-				if (getSelectedIndex() >= lbItems->items.size())
+				if (getSelectedIndex() >= lbItems->size())
 					return;
 
-				selectedLabel->setText(lbItems->items[getSelectedIndex()]->getText());
+				selectedLabel->setText(lbItems->getOption(getSelectedIndex()));
 				toggleOpen();
 			}
 		}
@@ -40,6 +40,8 @@ protected:
 	RUListbox* lbItems;
 	RUImageComponent* arrow;
 
+	unsigned int getListRows() const;
+
 	// events
 	void (GPanel::*OptionChangedListener)(int);
 	virtual void onMouseDown(GPanel*, int, int);
@@ -65,6 +67,8 @@ public:
 	void setOptionsShown(unsigned int);
 	void setSelectedIndex(unsigned int);
 	void addOption(std::string);
+	void addOptions(const std::vector<std::string>&);
+	void setSearchEnabled(bool);
 	void clearOptions();
 
 	// events
@@ -72,6 +76,7 @@ public:
 
 	// render
 	virtual void updateBackground(SDL_Renderer*);
+	virtual SDL_Rect getClipRect() const;
 	virtual std::string getType() const;
 };
 
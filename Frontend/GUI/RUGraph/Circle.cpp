@@ -16,19 +16,74 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Circle.h"
 #include "../../GFXUtilities/point2.h"
-#include "../../Graphics/graphics.h"
+#include "../../GFXUtilities/WorkerPool.h"
 #include "RUGraph.h"
 
-Circle::Circle(RUGraph* newParent, SDL_Color newColor) : Graphable(newParent, newColor)
+/*!
+ * @brief HeatmapColorJob
+ * @details maps one band of rows in the dirty rect to colors
+ */
+class HeatmapColorJob : public WorkerJob
+{
+public:
+	const unsigned int* heatmap;
+	Uint32* pixels;
+	const Colormap* colormap;
+	unsigned int maxHit;
+	int width;
+	int startX;
+	int endX;
+	int startY;
+	int endY;
+	unsigned int bandCount;
+
+	virtual void run(unsigned int band)
+	{
+		unsigned int rowCount = endY - startY;
+		int bandStart = startY + (int)(((unsigned long)rowCount * band) / bandCount);
+		int bandEnd = startY + (int)(((unsigned long)rowCount * (band + 1)) / bandCount);
+		for (int y = bandStart; y < bandEnd; ++y)
+		{
+			unsigned int row = (y * width) + startX;
+			colormap->mapCounts(&heatmap[row], endX - startX, &pixels[row], maxHit);
+		}
+	}
+};
+
+Circle::Circle(RUGraph* newParent, SDL_Color newColor)
+	: Graphable(newParent, newColor), colormap(Colormap::HUE)
 {
 	radius = 0.0f;
 	maxHit = 0;
+	heatmapX = 0;
+	heatmapY = 0;
+	heatmapWidth = 0;
+	heatmapHeight = 0;
+	diskRadius = -1;
+	heatmapTexture = NULL;
+	textureWidth = 0;
+	textureHeight = 0;
+	dirtyRect.x = 0;
+	dirtyRect.y = 0;
+	dirtyRect.w = 0;
+	dirtyRect.h = 0;
+	fullRecolor = false;
+	fullUpload = false;
+	colorMaxHit = 0;
 }
 
 Circle::~Circle()
 {
 	radius = 0.0f;
 	maxHit = 0;
+
+	for (unsigned int i = 0; i < foci.size(); ++i)
+		delete foci[i];
+	foci.clear();
+
+	if (heatmapTexture)
+		SDL_DestroyTexture(heatmapTexture);
+	heatmapTexture = NULL;
 }
 
 void Circle::addFocalPoint(const Point2* newFocalPoint)
@@ -39,124 +94,330 @@ void Circle::addFocalPoint(const Point2* newFocalPoint)
 	const Point2* newFocalPointCopy =
 		new Point2(floor(newFocalPoint->getX()), floor(newFocalPoint->getY()));
 	foci.push_back(newFocalPointCopy);
-	createHeatmap();
+
+	// one focus stamps a disk, two or more only stamp segments
+	if ((foci.size() <= 2) || (heatmap.empty()))
+		createHeatmap();
+	else
+		addFocusSegments(foci.size() - 1);
+	invalidate();
 }
 
 void Circle::setRadius(double newRadius)
 {
 	radius = newRadius;
 	createHeatmap();
+	invalidate();
 }
 
-void Circle::createHeatmap()
+/*!
+ * @brief build the disk stamp
+ * @details caches the span of every row of a disk with the current radius so stamping is a run
+ * of increments with no distance math
+ */
+void Circle::buildDisk()
 {
-	heatmap.clear();
+	diskRadius = (int)radius;
+	diskSpans.clear();
 
-	// Circle
-	if (foci.size() == 1)
+	const double radiusSq = radius * radius;
+	for (int j = -diskRadius; j < diskRadius; ++j)
 	{
-		for (unsigned int focalIndex = 0; focalIndex < foci.size(); ++focalIndex)
+		// cells inside the disk, i in [-diskRadius, diskRadius)
+		int start = diskRadius;
+		int end = -diskRadius;
+		for (int i = -diskRadius; i < diskRadius; ++i)
 		{
-			const Point2* cFocalPoint = foci[focalIndex];
-			for (int i = -radius; i < radius; ++i)
-			{
-				int xIndex = cFocalPoint->getX() + i;
-
-				std::map<int, int> newMap;
-				for (int j = -radius; j < radius; ++j)
-				{
-					int yIndex = cFocalPoint->getY() + j;
-
-					// calculate the distance
-					double distance = sqrt(pow(((double)i), 2.0f) + pow(((double)j), 2.0f));
-					double hue =
-						distance / sqrt(pow(((double)radius), 2.0f) + pow(((double)radius), 2.0f));
-					if (distance > radius)
-						continue;
-
-					// printf("i(%d,%d:%ld)\n", focalIndex, xIndex, heatmap.size());
-					if (heatmap.find(xIndex) == heatmap.end())
-						heatmap.insert(std::pair<int, std::map<int, int> >(xIndex, newMap));
-
-					// printf("j(%d:%d:%ld)\n", focalIndex, yIndex, heatmap[xIndex].size());
-					if (heatmap[xIndex].find(yIndex) == heatmap[xIndex].end())
-						heatmap[xIndex].insert(std::pair<int, int>(yIndex, 0));
-
-					// tick
-					++heatmap[xIndex][yIndex];
-
-					if (heatmap[xIndex][yIndex] > maxHit)
-						maxHit = heatmap[xIndex][yIndex];
-				}
-			}
+			if (((double)((i * i) + (j * j))) > radiusSq)
+				continue;
+
+			if (i < start)
+				start = i;
+			end = i + 1;
 		}
+
+		diskSpans.push_back(std::pair<int, int>(start, end));
+	}
+}
+
+/*!
+ * @brief stamp a disk
+ * @details adds one hit to every cell of the disk centered on (cx, cy)
+ * @param cx the center x in graph coordinates
+ * @param cy the center y in graph coordinates
+ */
+void Circle::stampDisk(int cx, int cy)
+{
+	markDirty(cx - diskRadius - heatmapX, cy - diskRadius - heatmapY, diskRadius * 2,
+			  diskRadius * 2);
+
+	for (unsigned int row = 0; row < diskSpans.size(); ++row)
+	{
+		int y = cy + ((int)row - diskRadius) - heatmapY;
+		if ((y < 0) || (y >= heatmapHeight))
+			continue;
+
+		int start = cx + diskSpans[row].first - heatmapX;
+		int end = cx + diskSpans[row].second - heatmapX;
+		if (start < 0)
+			start = 0;
+		if (end > heatmapWidth)
+			end = heatmapWidth;
+
+		unsigned int* cell = &heatmap[y * heatmapWidth];
+		for (int x = start; x < end; ++x)
+		{
+			++cell[x];
+			if (cell[x] > maxHit)
+				maxHit = cell[x];
+		}
+	}
+}
+
+/*!
+ * @brief stamp a segment
+ * @details stamps ELLIPSE_STEPS + 1 evenly spaced disks from one focal point to another
+ * @param fp1 the first focal point
+ * @param fp2 the second focal point
+ */
+void Circle::stampSegment(const Point2* fp1, const Point2* fp2)
+{
+	double deltaX = fp2->getX() - fp1->getX();
+	double deltaY = fp2->getY() - fp1->getY();
+	for (int step = 0; step <= ELLIPSE_STEPS; ++step)
+	{
+		double t = ((double)step) / ((double)ELLIPSE_STEPS);
+		stampDisk((int)(fp1->getX() + (deltaX * t)), (int)(fp1->getY() + (deltaY * t)));
+	}
+}
+
+/*!
+ * @brief grow the heatmap
+ * @details widens the grid so a disk centered on (cx, cy) fits, keeping the existing counts
+ * @param cx the center x in graph coordinates
+ * @param cy the center y in graph coordinates
+ */
+void Circle::growHeatmap(int cx, int cy)
+{
+	int minX = heatmapX, minY = heatmapY;
+	int maxX = heatmapX + heatmapWidth, maxY = heatmapY + heatmapHeight;
+	if (cx - diskRadius < minX)
+		minX = cx - diskRadius;
+	if (cy - diskRadius < minY)
+		minY = cy - diskRadius;
+	if (cx + diskRadius > maxX)
+		maxX = cx + diskRadius;
+	if (cy + diskRadius > maxY)
+		maxY = cy + diskRadius;
+
+	int newWidth = maxX - minX, newHeight = maxY - minY;
+	if ((newWidth == heatmapWidth) && (newHeight == heatmapHeight))
+		return;
+
+	// copy the old counts into place
+	std::vector<unsigned int> newHeatmap(newWidth * newHeight, 0);
+	int offsetX = heatmapX - minX, offsetY = heatmapY - minY;
+	for (int y = 0; y < heatmapHeight; ++y)
+	{
+		const unsigned int* src = &heatmap[y * heatmapWidth];
+		unsigned int* dst = &newHeatmap[((y + offsetY) * newWidth) + offsetX];
+		for (int x = 0; x < heatmapWidth; ++x)
+			dst[x] = src[x];
+	}
+
+	heatmap.swap(newHeatmap);
+	heatmapX = minX;
+	heatmapY = minY;
+	heatmapWidth = newWidth;
+	heatmapHeight = newHeight;
+	fullRecolor = true;
+}
+
+/*!
+ * @brief add the segments of a focus
+ * @details stamps only the segments between a new focus and the earlier ones, both directions,
+ * instead of rebuilding the heatmap
+ * @param newIndex the index of the new focus
+ */
+void Circle::addFocusSegments(unsigned int newIndex)
+{
+	const Point2* newFocus = foci[newIndex];
+	growHeatmap(newFocus->getX(), newFocus->getY());
+
+	for (unsigned int focalIndex = 0; focalIndex < newIndex; ++focalIndex)
+	{
+		stampSegment(foci[focalIndex], newFocus);
+		stampSegment(newFocus, foci[focalIndex]);
+	}
+}
+
+/*!
+ * @brief mark dirty
+ * @details grows the dirty rect by a rect in heatmap coordinates, clipped to the heatmap
+ */
+void Circle::markDirty(int x, int y, int w, int h)
+{
+	if (x < 0)
+	{
+		w += x;
+		x = 0;
+	}
+	if (y < 0)
+	{
+		h += y;
+		y = 0;
+	}
+	if (x + w > heatmapWidth)
+		w = heatmapWidth - x;
+	if (y + h > heatmapHeight)
+		h = heatmapHeight - y;
+	if ((w <= 0) || (h <= 0))
+		return;
+
+	if ((dirtyRect.w <= 0) || (dirtyRect.h <= 0))
+	{
+		dirtyRect.x = x;
+		dirtyRect.y = y;
+		dirtyRect.w = w;
+		dirtyRect.h = h;
+		return;
 	}
+
+	int right = dirtyRect.x + dirtyRect.w, bottom = dirtyRect.y + dirtyRect.h;
+	if (x + w > right)
+		right = x + w;
+	if (y + h > bottom)
+		bottom = y + h;
+	if (x < dirtyRect.x)
+		dirtyRect.x = x;
+	if (y < dirtyRect.y)
+		dirtyRect.y = y;
+	dirtyRect.w = right - dirtyRect.x;
+	dirtyRect.h = bottom - dirtyRect.y;
+}
+
+void Circle::createHeatmap()
+{
+	maxHit = 0;
+	heatmap.clear();
+	heatmapWidth = 0;
+	heatmapHeight = 0;
+	dirtyRect.w = 0;
+	dirtyRect.h = 0;
+	fullRecolor = true;
+
+	if ((radius <= 0) || (foci.empty()))
+		return;
+
+	buildDisk();
+
+	// bounding box of every stamp
+	int minX = foci[0]->getX(), maxX = minX;
+	int minY = foci[0]->getY(), maxY = minY;
+	for (unsigned int i = 1; i < foci.size(); ++i)
+	{
+		int x = foci[i]->getX(), y = foci[i]->getY();
+		if (x < minX)
+			minX = x;
+		if (x > maxX)
+			maxX = x;
+		if (y < minY)
+			minY = y;
+		if (y > maxY)
+			maxY = y;
+	}
+
+	heatmapX = minX - diskRadius;
+	heatmapY = minY - diskRadius;
+	heatmapWidth = (maxX - minX) + (diskRadius * 2);
+	heatmapHeight = (maxY - minY) + (diskRadius * 2);
+	if ((heatmapWidth <= 0) || (heatmapHeight <= 0))
+		return;
+
+	heatmap.assign(heatmapWidth * heatmapHeight, 0);
+
+	// Circle
+	if (foci.size() == 1)
+		stampDisk(foci[0]->getX(), foci[0]->getY());
 	// Ellipse
-	else if (foci.size() > 1)
+	else
 	{
-		// Keep ellipseDetail (0,1]
-		double ellipseDetail = 0.25f;
 		for (unsigned int focalIndex1 = 0; focalIndex1 < foci.size(); ++focalIndex1)
 		{
-			const Point2* fp1 = foci[focalIndex1];
 			for (unsigned int focalIndex2 = 0; focalIndex2 < foci.size(); ++focalIndex2)
 			{
-				const Point2* fp2 = foci[focalIndex2];
-
 				if (focalIndex1 == focalIndex2)
 					continue;
 
-				// slope of a line
-				double deltaX = fp2->getX() - fp1->getX();
-				double deltaY = fp2->getY() - fp1->getY();
-				double slope = deltaY / deltaX;
-
-				double stepX = abs(deltaX * ellipseDetail);
-				double stepY = abs(deltaY * ellipseDetail);
-
-				Point2 cp((deltaX >= 0) ? fp1->getX() : fp2->getX(),
-						  (deltaY >= 0) ? fp1->getY() : fp2->getY());
-				while (((deltaX >= 0) ? cp.getX() <= fp2->getX() : cp.getX() <= fp1->getX()) &&
-					   ((deltaY >= 0) ? cp.getY() <= fp2->getY() : cp.getY() <= fp1->getY()))
-				{
-					// draw a circle around a point
-					for (int i = -radius; i < radius; ++i)
-					{
-						int xIndex = cp.getX() + i;
-						std::map<int, int> newMap;
-						for (int j = -radius; j < radius; ++j)
-						{
-							int yIndex = cp.getY() + j;
-
-							// calculate the distance
-							double distance = sqrt(pow(((double)i), 2.0f) + pow(((double)j), 2.0f));
-							if (distance > radius)
-								continue;
-
-							// printf("i(%d,%d:%ld)\n", focalIndex, xIndex, heatmap.size());
-							if (heatmap.find(xIndex) == heatmap.end())
-								heatmap.insert(std::pair<int, std::map<int, int> >(xIndex, newMap));
-
-							// printf("j(%d:%d:%ld)\n", focalIndex, yIndex, heatmap[xIndex].size());
-							if (heatmap[xIndex].find(yIndex) == heatmap[xIndex].end())
-								heatmap[xIndex].insert(std::pair<int, int>(yIndex, 0));
-
-							// tick
-							++heatmap[xIndex][yIndex];
-
-							if (heatmap[xIndex][yIndex] > maxHit)
-								maxHit = heatmap[xIndex][yIndex];
-						}
-					}
-
-					cp.setX(cp.getX() + stepX);
-					cp.setY(cp.getY() + stepY);
-				}
+				stampSegment(foci[focalIndex1], foci[focalIndex2]);
 			}
 		}
 	}
 }
 
+/*!
+ * @brief colorize
+ * @details maps the hit counts to RGBA through the hue colormap. Only the dirty rect is
+ * recolored unless the grid or maxHit changed, since maxHit sets the scale of every cell.
+ * Large rects are split into row bands across the worker pool.
+ */
+void Circle::colorize()
+{
+	const unsigned int cellCount = heatmap.size();
+	if (pixels.size() != cellCount)
+	{
+		pixels.resize(cellCount);
+		fullRecolor = true;
+	}
+
+	if (maxHit != colorMaxHit)
+		fullRecolor = true;
+
+	int startX = dirtyRect.x, startY = dirtyRect.y;
+	int endX = dirtyRect.x + dirtyRect.w, endY = dirtyRect.y + dirtyRect.h;
+	if (fullRecolor)
+	{
+		startX = 0;
+		startY = 0;
+		endX = heatmapWidth;
+		endY = heatmapHeight;
+		fullUpload = true;
+	}
+
+	fullRecolor = false;
+	colorMaxHit = maxHit;
+	if ((cellCount == 0) || (maxHit == 0) || (endX <= startX))
+		return;
+
+	HeatmapColorJob colorJob;
+	colorJob.heatmap = &heatmap[0];
+	colorJob.pixels = &pixels[0];
+	colorJob.colormap = &colormap;
+	colorJob.maxHit = maxHit;
+	colorJob.width = heatmapWidth;
+	colorJob.startX = startX;
+	colorJob.endX = endX;
+	colorJob.startY = startY;
+	colorJob.endY = endY;
+
+	// small dirty rects are not worth waking the pool for
+	unsigned int dirtyCells = (unsigned int)((endX - startX) * (endY - startY));
+	if (dirtyCells < COLORIZE_TASK_CELLS)
+	{
+		colorJob.bandCount = 1;
+		colorJob.run(0);
+		return;
+	}
+
+	WorkerPool* pool = WorkerPool::getSharedPool();
+	unsigned int bandCount = pool->size();
+	if (bandCount > (unsigned int)(endY - startY))
+		bandCount = endY - startY;
+
+	colorJob.bandCount = bandCount;
+	pool->run(&colorJob, bandCount);
+}
+
 const Point2* Circle::getFocalPoint(unsigned int index) const
 {
 	if (index >= foci.size())
@@ -178,34 +439,60 @@ void Circle::draw(SDL_Renderer* renderer)
 	if (foci.size() == 0)
 		return;
 
-	SDL_SetRenderDrawColor(renderer, getColor().r, getColor().g, getColor().b, getColor().a);
+	if (heatmap.empty())
+		return;
+
+	bool changed = (fullRecolor) || ((dirtyRect.w > 0) && (dirtyRect.h > 0));
+	if (changed)
+		colorize();
 
-	std::map<int, std::map<int, int> >::const_iterator itr = heatmap.begin();
-	for (; itr != heatmap.end(); ++itr)
+	// match the heatmap size
+	if ((heatmapTexture) && ((textureWidth != heatmapWidth) || (textureHeight != heatmapHeight)))
 	{
-		int xIndex = itr->first;
-		std::map<int, int>::const_iterator itr2 = heatmap[xIndex].begin();
-		for (; itr2 != heatmap[xIndex].end(); ++itr2)
-		{
-			int yIndex = itr2->first;
-			int cHeat = itr2->second;
-			// printf("heatmap[%d][%d]: %d\n", xIndex, yIndex, cHeat);
-
-			// calculate the hue
-			double hue = ((double)cHeat) / ((double)maxHit);
-			hue = 1.0f - hue;
-
-			// get the color
-			int8_t redMask = 0;
-			int8_t greenMask = 0;
-			int8_t blueMask = 0;
-			unsigned int colorMask = Graphics::RGBfromHue(hue, &redMask, &greenMask, &blueMask);
-
-			// set the color and draw the point
-			SDL_SetRenderDrawColor(renderer, redMask, greenMask, blueMask, SDL_ALPHA_OPAQUE);
-			SDL_RenderDrawPoint(renderer, parent->getX() + xIndex, parent->getY() + yIndex);
-		}
+		SDL_DestroyTexture(heatmapTexture);
+		heatmapTexture = NULL;
 	}
+
+	if (!heatmapTexture)
+	{
+		heatmapTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+										   SDL_TEXTUREACCESS_STREAMING, heatmapWidth, heatmapHeight);
+		if (!heatmapTexture)
+			return;
+
+		SDL_SetTextureBlendMode(heatmapTexture, SDL_BLENDMODE_BLEND);
+		textureWidth = heatmapWidth;
+		textureHeight = heatmapHeight;
+		fullUpload = true;
+	}
+
+	// upload the whole heatmap or just the cells that changed
+	if (fullUpload)
+		SDL_UpdateTexture(heatmapTexture, NULL, &pixels[0], heatmapWidth * sizeof(Uint32));
+	else if (changed)
+		SDL_UpdateTexture(heatmapTexture, &dirtyRect,
+						  &pixels[(dirtyRect.y * heatmapWidth) + dirtyRect.x],
+						  heatmapWidth * sizeof(Uint32));
+
+	fullUpload = false;
+	dirtyRect.w = 0;
+	dirtyRect.h = 0;
+
+	SDL_Rect dRect;
+	dRect.x = heatmapX;
+	dRect.y = heatmapY;
+	dRect.w = heatmapWidth;
+	dRect.h = heatmapHeight;
+	SDL_RenderCopy(renderer, heatmapTexture, NULL, &dRect);
+}
+
+void Circle::releaseTextures()
+{
+	if (heatmapTexture)
+		SDL_DestroyTexture(heatmapTexture);
+	heatmapTexture = NULL;
+
+	Graphable::releaseTextures();
 }
 
 std::string Circle::getType() const
@@ -17,6 +17,7 @@
 #ifndef _RUCIRCLE
 #define _RUCIRCLE
 
+#include "../../GFXUtilities/Colormap.h"
 #include "Graphable.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -33,12 +34,46 @@ class Point2;
 class Circle : public Graphable
 {
 private:
-	std::map<int, std::map<int, int> > heatmap;
 	std::vector<const Point2*> foci;
 	double radius;
-	int maxHit;
+	unsigned int maxHit;
+
+	// dense hit counts over the bounding box of every stamp
+	std::vector<unsigned int> heatmap;
+	int heatmapX;
+	int heatmapY;
+	int heatmapWidth;
+	int heatmapHeight;
+
+	// [start, end) x offsets of the disk stamp for each y offset from -diskRadius
+	std::vector<std::pair<int, int> > diskSpans;
+	int diskRadius;
+
+	// colored heatmap and its texture
+	std::vector<Uint32> pixels;
+	Colormap colormap;
+	SDL_Texture* heatmapTexture;
+	int textureWidth;
+	int textureHeight;
+
+	// cells changed since the last upload, heatmap coordinates
+	SDL_Rect dirtyRect;
+	bool fullRecolor;
+	bool fullUpload;
+	unsigned int colorMaxHit;
+
+	void buildDisk();
+	void growHeatmap(int, int);
+	void stampDisk(int, int);
+	void stampSegment(const Point2*, const Point2*);
+	void addFocusSegments(unsigned int);
+	void markDirty(int, int, int, int);
+	void colorize();
 
 public:
+	static const int ELLIPSE_STEPS = 4;
+	static const unsigned int COLORIZE_TASK_CELLS = 65536;
+
 	// constructors & destructor
 	Circle(RUGraph*, SDL_Color);
 	~Circle();
@@ -50,6 +85,7 @@ public:
 	const Point2* getFocalPoint(unsigned int) const;
 	double getRadius() const;
 
+	virtual void releaseTextures();
 	virtual void draw(SDL_Renderer*);
 	virtual std::string getType() const;
 };
@@ -0,0 +1,449 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "DrawCanvas.h"
+#include <math.h>
+
+DrawCanvas::Tile::Tile() : pixels(TILE_SIZE * TILE_SIZE, 0)
+{
+	refs = 1;
+}
+
+DrawCanvas::DrawCanvas()
+{
+	width = 0;
+	height = 0;
+	tilesX = 0;
+	tilesY = 0;
+	allDirty = true;
+
+	stroking = false;
+	lastX = 0.0f;
+	lastY = 0.0f;
+	penRadius = 0.0f;
+	penColor = 0x000000FF;
+
+	stampRadius = -1;
+	stampSpanRadius = -1.0f;
+
+	texture = NULL;
+	textureWidth = 0;
+	textureHeight = 0;
+}
+
+DrawCanvas::~DrawCanvas()
+{
+	releaseTiles();
+
+	if (texture)
+		SDL_DestroyTexture(texture);
+	texture = NULL;
+}
+
+int DrawCanvas::getWidth() const
+{
+	return width;
+}
+
+int DrawCanvas::getHeight() const
+{
+	return height;
+}
+
+bool DrawCanvas::isStroking() const
+{
+	return stroking;
+}
+
+bool DrawCanvas::canUndo() const
+{
+	return !undoStack.empty();
+}
+
+bool DrawCanvas::canRedo() const
+{
+	return !redoStack.empty();
+}
+
+/*!
+ * @brief resize
+ * @details sets the canvas size, which starts out empty and drops the undo history
+ * @param newWidth the width in pixels
+ * @param newHeight the height in pixels
+ */
+void DrawCanvas::resize(int newWidth, int newHeight)
+{
+	if ((newWidth == width) && (newHeight == height))
+		return;
+
+	releaseTiles();
+	width = (newWidth > 0) ? newWidth : 0;
+	height = (newHeight > 0) ? newHeight : 0;
+	tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	tiles.resize(tilesX * tilesY);
+	for (unsigned int i = 0; i < tiles.size(); ++i)
+		tiles[i] = new Tile();
+	dirtyTiles.assign(tiles.size(), false);
+	allDirty = true;
+}
+
+void DrawCanvas::setPenRadius(float newPenRadius)
+{
+	penRadius = newPenRadius;
+}
+
+/*!
+ * @brief set the pen color
+ * @param newPenColor a packed RGBA8888 color
+ */
+void DrawCanvas::setPenColor(Uint32 newPenColor)
+{
+	penColor = newPenColor;
+}
+
+/*!
+ * @brief clear
+ * @details wipes the canvas as one undoable step
+ */
+void DrawCanvas::clear()
+{
+	if (tiles.empty())
+		return;
+
+	endStroke();
+	undoStack.push_back(takeSnapshot());
+	if (undoStack.size() > MAX_UNDO)
+	{
+		releaseSnapshot(undoStack.front());
+		undoStack.erase(undoStack.begin());
+	}
+
+	for (unsigned int i = 0; i < redoStack.size(); ++i)
+		releaseSnapshot(redoStack[i]);
+	redoStack.clear();
+
+	for (unsigned int i = 0; i < tiles.size(); ++i)
+	{
+		--tiles[i]->refs;
+		if (tiles[i]->refs == 0)
+			delete tiles[i];
+		tiles[i] = new Tile();
+	}
+	allDirty = true;
+}
+
+void DrawCanvas::releaseTiles()
+{
+	stroking = false;
+	for (unsigned int i = 0; i < undoStack.size(); ++i)
+		releaseSnapshot(undoStack[i]);
+	undoStack.clear();
+	for (unsigned int i = 0; i < redoStack.size(); ++i)
+		releaseSnapshot(redoStack[i]);
+	redoStack.clear();
+
+	releaseSnapshot(tiles);
+	dirtyTiles.clear();
+	tilesX = 0;
+	tilesY = 0;
+}
+
+DrawCanvas::Snapshot DrawCanvas::takeSnapshot() const
+{
+	Snapshot snapshot(tiles);
+	for (unsigned int i = 0; i < snapshot.size(); ++i)
+		++snapshot[i]->refs;
+
+	return snapshot;
+}
+
+void DrawCanvas::releaseSnapshot(Snapshot& snapshot)
+{
+	for (unsigned int i = 0; i < snapshot.size(); ++i)
+	{
+		--snapshot[i]->refs;
+		if (snapshot[i]->refs == 0)
+			delete snapshot[i];
+	}
+	snapshot.clear();
+}
+
+/*!
+ * @brief restore a snapshot
+ * @details swaps the snapshot in as the live tiles, the old live tiles are left in the snapshot.
+ * Only the tiles that differ are marked for upload.
+ * @param snapshot the snapshot to restore
+ */
+void DrawCanvas::restoreSnapshot(Snapshot& snapshot)
+{
+	for (unsigned int i = 0; i < tiles.size(); ++i)
+	{
+		if (tiles[i] != snapshot[i])
+			dirtyTiles[i] = true;
+	}
+
+	tiles.swap(snapshot);
+}
+
+/*!
+ * @brief get a writable tile
+ * @details copies a tile that a snapshot still shares before it is written
+ * @param index the tile index
+ * @return the tile
+ */
+DrawCanvas::Tile* DrawCanvas::getWritableTile(int index)
+{
+	Tile* cTile = tiles[index];
+	if (cTile->refs > 1)
+	{
+		Tile* copy = new Tile();
+		copy->pixels = cTile->pixels;
+		--cTile->refs;
+		tiles[index] = copy;
+		cTile = copy;
+	}
+
+	dirtyTiles[index] = true;
+	return cTile;
+}
+
+void DrawCanvas::buildStamp()
+{
+	if (penRadius == stampSpanRadius)
+		return;
+
+	stampSpanRadius = penRadius;
+	stampRadius = (int)penRadius;
+	stampSpans.clear();
+
+	const float radiusSq = penRadius * penRadius;
+	for (int j = -stampRadius; j < stampRadius; ++j)
+	{
+		int start = stampRadius;
+		int end = -stampRadius;
+		for (int i = -stampRadius; i < stampRadius; ++i)
+		{
+			if (((float)((i * i) + (j * j))) > radiusSq)
+				continue;
+
+			if (i < start)
+				start = i;
+			end = i + 1;
+		}
+
+		stampSpans.push_back(std::pair<int, int>(start, end));
+	}
+}
+
+/*!
+ * @brief stamp the pen
+ * @details paints one pen disk centered on (cx, cy), tile by tile
+ */
+void DrawCanvas::stamp(int cx, int cy)
+{
+	for (unsigned int row = 0; row < stampSpans.size(); ++row)
+	{
+		int y = cy + ((int)row - stampRadius);
+		if ((y < 0) || (y >= height))
+			continue;
+
+		int start = cx + stampSpans[row].first;
+		int end = cx + stampSpans[row].second;
+		if (start < 0)
+			start = 0;
+		if (end > width)
+			end = width;
+
+		// split the span at tile edges
+		int tileRow = y / TILE_SIZE;
+		int tileY = y % TILE_SIZE;
+		while (start < end)
+		{
+			int tileCol = start / TILE_SIZE;
+			int tileEnd = (tileCol + 1) * TILE_SIZE;
+			if (tileEnd > end)
+				tileEnd = end;
+
+			Tile* cTile = getWritableTile((tileRow * tilesX) + tileCol);
+			Uint32* pixel = &cTile->pixels[(tileY * TILE_SIZE) + (start - (tileCol * TILE_SIZE))];
+			for (int x = start; x < tileEnd; ++x, ++pixel)
+				*pixel = penColor;
+
+			start = tileEnd;
+		}
+	}
+}
+
+/*!
+ * @brief begin a stroke
+ * @details snapshots the canvas for undo and stamps the first pen disk
+ * @param x the x position in canvas pixels
+ * @param y the y position in canvas pixels
+ */
+void DrawCanvas::beginStroke(float x, float y)
+{
+	if (tiles.empty())
+		return;
+
+	endStroke();
+	undoStack.push_back(takeSnapshot());
+	if (undoStack.size() > MAX_UNDO)
+	{
+		releaseSnapshot(undoStack.front());
+		undoStack.erase(undoStack.begin());
+	}
+
+	for (unsigned int i = 0; i < redoStack.size(); ++i)
+		releaseSnapshot(redoStack[i]);
+	redoStack.clear();
+
+	stroking = true;
+	lastX = x;
+	lastY = y;
+
+	buildStamp();
+	stamp((int)x, (int)y);
+}
+
+/*!
+ * @brief stroke to
+ * @details continues the stroke to a new sample, stamping along the segment from the last one so
+ * fast mouse motion leaves no gaps
+ * @param x the x position in canvas pixels
+ * @param y the y position in canvas pixels
+ */
+void DrawCanvas::strokeTo(float x, float y)
+{
+	if (!stroking)
+		return;
+
+	float deltaX = x - lastX;
+	float deltaY = y - lastY;
+	float distance = sqrtf((deltaX * deltaX) + (deltaY * deltaY));
+
+	// overlap the disks by half a radius
+	float spacing = penRadius / 2.0f;
+	if (spacing < 1.0f)
+		spacing = 1.0f;
+
+	int steps = (int)(distance / spacing);
+	for (int i = 1; i <= steps; ++i)
+	{
+		float t = (i * spacing) / distance;
+		stamp((int)(lastX + (deltaX * t)), (int)(lastY + (deltaY * t)));
+	}
+
+	if ((steps == 0) || ((steps * spacing) < distance))
+		stamp((int)x, (int)y);
+
+	lastX = x;
+	lastY = y;
+}
+
+void DrawCanvas::endStroke()
+{
+	stroking = false;
+}
+
+bool DrawCanvas::undo()
+{
+	if (undoStack.empty())
+		return false;
+
+	endStroke();
+	restoreSnapshot(undoStack.back());
+	redoStack.push_back(undoStack.back());
+	undoStack.pop_back();
+	return true;
+}
+
+bool DrawCanvas::redo()
+{
+	if (redoStack.empty())
+		return false;
+
+	endStroke();
+	restoreSnapshot(redoStack.back());
+	undoStack.push_back(redoStack.back());
+	redoStack.pop_back();
+	return true;
+}
+
+/*!
+ * @brief release
+ * @details frees the texture, every tile is uploaded again on the next draw
+ */
+void DrawCanvas::release()
+{
+	if (texture)
+		SDL_DestroyTexture(texture);
+	texture = NULL;
+}
+
+/*!
+ * @brief draw
+ * @details uploads the dirty tiles and copies the canvas to the render target
+ * @param renderer the renderer
+ */
+void DrawCanvas::draw(SDL_Renderer* renderer)
+{
+	if ((!renderer) || (tiles.empty()))
+		return;
+
+	// match the canvas size
+	if ((texture) && ((textureWidth != width) || (textureHeight != height)))
+	{
+		SDL_DestroyTexture(texture);
+		texture = NULL;
+	}
+
+	if (!texture)
+	{
+		texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+									SDL_TEXTUREACCESS_STREAMING, width, height);
+		if (!texture)
+			return;
+
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		textureWidth = width;
+		textureHeight = height;
+		allDirty = true;
+	}
+
+	for (int tileRow = 0; tileRow < tilesY; ++tileRow)
+	{
+		for (int tileCol = 0; tileCol < tilesX; ++tileCol)
+		{
+			int index = (tileRow * tilesX) + tileCol;
+			if ((!allDirty) && (!dirtyTiles[index]))
+				continue;
+
+			SDL_Rect tileRect;
+			tileRect.x = tileCol * TILE_SIZE;
+			tileRect.y = tileRow * TILE_SIZE;
+			tileRect.w = (tileRect.x + TILE_SIZE > width) ? width - tileRect.x : TILE_SIZE;
+			tileRect.h = (tileRect.y + TILE_SIZE > height) ? height - tileRect.y : TILE_SIZE;
+			SDL_UpdateTexture(texture, &tileRect, &tiles[index]->pixels[0],
+							  TILE_SIZE * sizeof(Uint32));
+			dirtyTiles[index] = false;
+		}
+	}
+
+	allDirty = false;
+	SDL_RenderCopy(renderer, texture, NULL, NULL);
+}
@@ -0,0 +1,117 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _DRAWCANVAS_H
+#define _DRAWCANVAS_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief DrawCanvas
+ * @details Persistent RGBA raster for freehand strokes. The canvas is split into square tiles;
+ * stamping only touches and uploads the tiles it covers, so the cost of a frame does not grow
+ * with the drawing history. Undo snapshots share tiles and a tile is only copied the first time
+ * it is written after a snapshot.
+ */
+
+class DrawCanvas
+{
+private:
+	class Tile
+	{
+	public:
+		std::vector<Uint32> pixels;
+		int refs;
+
+		Tile();
+	};
+
+	typedef std::vector<Tile*> Snapshot;
+
+	int width;
+	int height;
+	int tilesX;
+	int tilesY;
+	Snapshot tiles;
+	std::vector<bool> dirtyTiles;
+	bool allDirty;
+
+	// undo and redo
+	std::vector<Snapshot> undoStack;
+	std::vector<Snapshot> redoStack;
+
+	// the stroke in progress
+	bool stroking;
+	float lastX;
+	float lastY;
+	float penRadius;
+	Uint32 penColor;
+
+	// [start, end) x offsets of the pen for each y offset from -stampRadius
+	std::vector<std::pair<int, int> > stampSpans;
+	int stampRadius;
+	float stampSpanRadius;
+
+	SDL_Texture* texture;
+	int textureWidth;
+	int textureHeight;
+
+	Tile* getWritableTile(int);
+	void buildStamp();
+	void stamp(int, int);
+	Snapshot takeSnapshot() const;
+	void releaseSnapshot(Snapshot&);
+	void restoreSnapshot(Snapshot&);
+	void releaseTiles();
+
+public:
+	static const int TILE_SIZE = 64;
+	static const unsigned int MAX_UNDO = 32;
+
+	// constructors & destructor
+	DrawCanvas();
+	~DrawCanvas();
+
+	// gets
+	int getWidth() const;
+	int getHeight() const;
+	bool isStroking() const;
+	bool canUndo() const;
+	bool canRedo() const;
+
+	// sets
+	void resize(int, int);
+	void setPenRadius(float);
+	void setPenColor(Uint32);
+	void clear();
+
+	// strokes
+	void beginStroke(float, float);
+	void strokeTo(float, float);
+	void endStroke();
+	bool undo();
+	bool redo();
+
+	// render
+	void release();
+	void draw(SDL_Renderer*);
+};
+
+#endif
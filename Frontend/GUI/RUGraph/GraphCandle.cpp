@@ -0,0 +1,384 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GraphCandle.h"
+#include "../../../include/Backend/Database/GList.h"
+#include "../../../include/Backend/Database/gtable.h"
+#include "../../GFXUtilities/point2.h"
+#include "RUGraph.h"
+#include <math.h>
+
+GraphCandle::GraphCandle(RUGraph* newParent, SDL_Color newColor) : Graphable(newParent, newColor)
+{
+	barsStaged = false;
+
+	// staging mutex
+	stageMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(stageMutex, NULL);
+}
+
+GraphCandle::~GraphCandle()
+{
+	clear();
+
+	// staging mutex
+	pthread_mutex_destroy(stageMutex);
+	free(stageMutex);
+}
+
+void GraphCandle::Bars::swap(Bars& other)
+{
+	opens.swap(other.opens);
+	highs.swap(other.highs);
+	lows.swap(other.lows);
+	closes.swap(other.closes);
+	highPyramid.swap(other.highPyramid);
+	lowPyramid.swap(other.lowPyramid);
+}
+
+void GraphCandle::Bars::clear()
+{
+	opens.clear();
+	highs.clear();
+	lows.clear();
+	closes.clear();
+	highPyramid.clear();
+	lowPyramid.clear();
+}
+
+unsigned int GraphCandle::size() const
+{
+	return bars.closes.size();
+}
+
+/*!
+ * @brief set the candles
+ * @details replaces the bars with four columns of equal length. The columns and pyramids are built
+ * without a lock and swapped into the staged slot, the renderer picks them up at its next frame.
+ * @param newOpens the open column
+ * @param newHighs the high column
+ * @param newLows the low column
+ * @param newCloses the close column
+ * @param count the number of bars
+ */
+void GraphCandle::setCandles(const float* newOpens, const float* newHighs, const float* newLows,
+							 const float* newCloses, unsigned int count)
+{
+	if ((!newOpens) || (!newHighs) || (!newLows) || (!newCloses))
+		return;
+
+	Bars newBars;
+	newBars.opens.assign(newOpens, newOpens + count);
+	newBars.highs.assign(newHighs, newHighs + count);
+	newBars.lows.assign(newLows, newLows + count);
+	newBars.closes.assign(newCloses, newCloses + count);
+	newBars.highPyramid.setValues(newHighs, count);
+	newBars.lowPyramid.setValues(newLows, count);
+
+	// appends queued before this are replaced too
+	pthread_mutex_lock(stageMutex);
+	stagedBars.swap(newBars);
+	barsStaged = true;
+	stagedAppends.clear();
+	pthread_mutex_unlock(stageMutex);
+}
+
+/*!
+ * @brief set the candles
+ * @details reads the bars from four columns of a table
+ * @param newCandles the table
+ * @param openCol the open column
+ * @param highCol the high column
+ * @param lowCol the low column
+ * @param closeCol the close column
+ */
+void GraphCandle::setCandles(const shmea::GTable& newCandles, unsigned int openCol,
+							 unsigned int highCol, unsigned int lowCol, unsigned int closeCol)
+{
+	const unsigned int colCount = newCandles.numberOfCols();
+	if ((openCol >= colCount) || (highCol >= colCount) || (lowCol >= colCount) ||
+		(closeCol >= colCount))
+		return;
+
+	const unsigned int count = newCandles.numberOfRows();
+	if (count == 0)
+		return;
+
+	shmea::GList openList = newCandles.getCol(openCol);
+	shmea::GList highList = newCandles.getCol(highCol);
+	shmea::GList lowList = newCandles.getCol(lowCol);
+	shmea::GList closeList = newCandles.getCol(closeCol);
+
+	std::vector<float> newOpens(count), newHighs(count), newLows(count), newCloses(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		newOpens[i] = openList.getFloat(i);
+		newHighs[i] = highList.getFloat(i);
+		newLows[i] = lowList.getFloat(i);
+		newCloses[i] = closeList.getFloat(i);
+	}
+
+	setCandles(&newOpens[0], &newHighs[0], &newLows[0], &newCloses[0], count);
+}
+
+/*!
+ * @brief append a candle
+ * @details queues a bar for the end, the renderer adds it in O(log n) at its next frame
+ */
+void GraphCandle::appendCandle(float newOpen, float newHigh, float newLow, float newClose)
+{
+	pthread_mutex_lock(stageMutex);
+	stagedAppends.push_back(newOpen);
+	stagedAppends.push_back(newHigh);
+	stagedAppends.push_back(newLow);
+	stagedAppends.push_back(newClose);
+	pthread_mutex_unlock(stageMutex);
+}
+
+/*!
+ * @brief update the series
+ * @details picks up the staged bars and the queued candles on the render thread. The caller holds
+ * plotMutex.
+ * @return true if the series changed
+ */
+bool GraphCandle::updateSeries()
+{
+	bool changed = Graphable::updateSeries();
+
+	// the old bars are freed after the unlock
+	Bars oldBars;
+	pthread_mutex_lock(stageMutex);
+	bool replaced = barsStaged;
+	if (barsStaged)
+	{
+		bars.swap(stagedBars);
+		stagedBars.swap(oldBars);
+		barsStaged = false;
+	}
+	std::vector<float> newAppends;
+	newAppends.swap(stagedAppends);
+	pthread_mutex_unlock(stageMutex);
+
+	for (unsigned int i = 0; i + 3 < newAppends.size(); i += 4)
+	{
+		bars.opens.push_back(newAppends[i]);
+		bars.highs.push_back(newAppends[i + 1]);
+		bars.lows.push_back(newAppends[i + 2]);
+		bars.closes.push_back(newAppends[i + 3]);
+		bars.highPyramid.push(newAppends[i + 1]);
+		bars.lowPyramid.push(newAppends[i + 2]);
+	}
+
+	if ((replaced) || (!newAppends.empty()))
+	{
+		layer.invalidate();
+		changed = true;
+	}
+
+	return changed;
+}
+
+void GraphCandle::clear()
+{
+	pthread_mutex_lock(stageMutex);
+	stagedBars.clear();
+	barsStaged = false;
+	stagedAppends.clear();
+	pthread_mutex_unlock(stageMutex);
+
+	pthread_mutex_lock(plotMutex);
+	bars.clear();
+	pthread_mutex_unlock(plotMutex);
+
+	Graphable::clear();
+}
+
+/*!
+ * @brief draw
+ * @details draws the bars inside the graph view, scaled to the high and low of the visible bars
+ * @param renderer the renderer
+ */
+void GraphCandle::draw(SDL_Renderer* renderer)
+{
+	const unsigned int barCount = bars.closes.size();
+	const int width = parent->getWidth();
+	if ((barCount == 0) || (width <= 0))
+		return;
+
+	// the view in bars, each bar takes one unit of the x axis
+	double viewFirst = parent->getViewStart() * barCount;
+	double viewSpan = (parent->getViewEnd() - parent->getViewStart()) * barCount;
+	unsigned int first = (unsigned int)viewFirst;
+	unsigned int last = (unsigned int)ceil(viewFirst + viewSpan);
+	if (last > barCount)
+		last = barCount;
+	if (first >= last)
+		return;
+
+	float unused;
+	bars.lowPyramid.getRange(first, last, y_min, unused);
+	bars.highPyramid.getRange(first, last, unused, y_max);
+	float yRange = y_max - y_min;
+	if (!(yRange > 0.0f))
+		yRange = 1.0f;
+
+	const int originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+	const float pointYGap = ((float)parent->getHeight()) / yRange;
+	const double barWidth = width / viewSpan;
+
+	wicks.clear();
+	risingBodies.clear();
+	fallingBodies.clear();
+
+	if (barWidth >= 1.0)
+	{
+		// one candle per bar
+		int bodyWidth = (int)((barWidth * BODY_PERCENT) / 100.0);
+		if (bodyWidth < 1)
+			bodyWidth = 1;
+
+		for (unsigned int i = first; i < last; ++i)
+		{
+			int center = originX + (int)((i + 0.5 - viewFirst) * barWidth);
+			addCandle(center, bodyWidth, bars.opens[i], bars.highs[i], bars.lows[i], bars.closes[i],
+					  baseY, pointYGap);
+		}
+	}
+	else
+	{
+		// one merged candle per pixel column
+		const double barsPerColumn = viewSpan / width;
+		for (int col = 0; col < width; ++col)
+		{
+			unsigned int start = (unsigned int)(viewFirst + (col * barsPerColumn));
+			unsigned int end = (unsigned int)(viewFirst + ((col + 1) * barsPerColumn));
+			if (end <= start)
+				end = start + 1;
+			if (end > barCount)
+				end = barCount;
+			if (start >= end)
+				break;
+
+			float columnHigh, columnLow;
+			bars.highPyramid.getRange(start, end, unused, columnHigh);
+			bars.lowPyramid.getRange(start, end, columnLow, unused);
+			addCandle(originX + col, 1, bars.opens[start], columnHigh, columnLow,
+					  bars.closes[end - 1], baseY, pointYGap);
+		}
+	}
+
+	SDL_SetRenderDrawColor(renderer, getColor().r, getColor().g, getColor().b, getColor().a);
+	if (!wicks.empty())
+		SDL_RenderFillRects(renderer, &wicks[0], wicks.size());
+	if (!fallingBodies.empty())
+		SDL_RenderFillRects(renderer, &fallingBodies[0], fallingBodies.size());
+	if (!risingBodies.empty())
+		SDL_RenderDrawRects(renderer, &risingBodies[0], risingBodies.size());
+}
+
+/*!
+ * @brief add a candle
+ * @details batches the wick and body of one candle. Rising bodies are hollow, so the wick is
+ * split around the body.
+ * @param center the x center of the candle
+ * @param bodyWidth the body width in pixels
+ */
+void GraphCandle::addCandle(int center, int bodyWidth, float candleOpen, float candleHigh,
+							float candleLow, float candleClose, float baseY, float pointYGap)
+{
+	int highY = (int)(baseY - ((candleHigh - y_min) * pointYGap));
+	int lowY = (int)(baseY - ((candleLow - y_min) * pointYGap));
+	int openY = (int)(baseY - ((candleOpen - y_min) * pointYGap));
+	int closeY = (int)(baseY - ((candleClose - y_min) * pointYGap));
+
+	bool rising = (candleClose >= candleOpen);
+	int bodyTop = rising ? closeY : openY;
+	int bodyBottom = rising ? openY : closeY;
+
+	SDL_Rect body;
+	body.x = center - (bodyWidth / 2);
+	body.y = bodyTop;
+	body.w = bodyWidth;
+	body.h = bodyBottom - bodyTop + 1;
+
+	SDL_Rect wick;
+	wick.x = center;
+	wick.w = 1;
+	if ((rising) && (bodyWidth > 2))
+	{
+		wick.y = highY;
+		wick.h = bodyTop - highY;
+		if (wick.h > 0)
+			wicks.push_back(wick);
+
+		wick.y = bodyBottom + 1;
+		wick.h = lowY - bodyBottom;
+		if (wick.h > 0)
+			wicks.push_back(wick);
+
+		risingBodies.push_back(body);
+		return;
+	}
+
+	wick.y = highY;
+	wick.h = lowY - highY + 1;
+	wicks.push_back(wick);
+	fallingBodies.push_back(body);
+}
+
+/*!
+ * @brief find the nearest point
+ * @details snaps to the close of the bar under the mouse
+ */
+bool GraphCandle::findNearest(int mouseX, int mouseY, Point2& value, SDL_Point& screenPoint,
+							  float& distance)
+{
+	const unsigned int barCount = bars.closes.size();
+	const int width = parent->getWidth();
+	if ((barCount == 0) || (width <= 0))
+		return false;
+
+	double viewFirst = parent->getViewStart() * barCount;
+	double viewSpan = (parent->getViewEnd() - parent->getViewStart()) * barCount;
+	double barWidth = width / viewSpan;
+	float yRange = y_max - y_min;
+	float pointYGap = (yRange > 0.0f) ? ((float)parent->getHeight()) / yRange : 0.0f;
+	const int originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+
+	double position = viewFirst + ((mouseX - originX) / barWidth);
+	if (position < 0.0)
+		position = 0.0;
+
+	unsigned int index = (unsigned int)position;
+	if (index >= barCount)
+		index = barCount - 1;
+	value.set(index, bars.closes[index]);
+
+	screenPoint.x = originX + (int)((index + 0.5 - viewFirst) * barWidth);
+	screenPoint.y = baseY - ((bars.closes[index] - y_min) * pointYGap);
+
+	float deltaX = (float)(screenPoint.x - mouseX);
+	float deltaY = (float)(screenPoint.y - mouseY);
+	distance = sqrtf((deltaX * deltaX) + (deltaY * deltaY));
+	return true;
+}
+
+std::string GraphCandle::getType() const
+{
+	return "GraphCandle";
+}
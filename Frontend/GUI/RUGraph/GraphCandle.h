@@ -0,0 +1,106 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GRAPHCANDLE_H
+#define _GRAPHCANDLE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "../../GFXUtilities/MinMaxPyramid.h"
+#include "../../GItems/RUColors.h"
+#include "Graphable.h"
+
+class RUGraph;
+
+namespace shmea {
+class GTable;
+};
+
+/*!
+ * @brief GraphCandle
+ * @details Open/high/low/close bars along the point index. Wicks and bodies are collected into
+ * rect batches and drawn in one call each. When there are more bars in the view than pixels, the
+ * bars behind each pixel column are merged into one candle, with the high and low looked up in
+ * O(log n) from min/max pyramids, so the cost follows the graph width. Producers build new bars
+ * without a lock and stage them, the renderer swaps them in at frame start.
+ */
+
+class GraphCandle : public Graphable
+{
+private:
+	class Bars
+	{
+	public:
+		std::vector<float> opens;
+		std::vector<float> highs;
+		std::vector<float> lows;
+		std::vector<float> closes;
+		MinMaxPyramid highPyramid;
+		MinMaxPyramid lowPyramid;
+
+		void swap(Bars&);
+		void clear();
+	};
+
+	// drawn by the renderer
+	Bars bars;
+
+	// staged by producers, held by stageMutex only to swap or queue
+	Bars stagedBars;
+	bool barsStaged;
+	std::vector<float> stagedAppends; // open, high, low, close per bar
+	pthread_mutex_t* stageMutex;
+
+	// batches, reused every draw
+	std::vector<SDL_Rect> wicks;
+	std::vector<SDL_Rect> risingBodies;
+	std::vector<SDL_Rect> fallingBodies;
+
+	void addCandle(int, int, float, float, float, float, float, float);
+
+protected:
+	virtual bool updateSeries();
+	virtual bool findNearest(int, int, Point2&, SDL_Point&, float&);
+
+public:
+	static const int BODY_PERCENT = 70;
+
+	// constructors & destructor
+	GraphCandle(RUGraph*, SDL_Color = RUColors::DEFAULT_COLOR_CANDLE);
+	~GraphCandle();
+
+	// gets
+	unsigned int size() const;
+
+	// sets
+	void setCandles(const float*, const float*, const float*, const float*, unsigned int);
+	void setCandles(const shmea::GTable&, unsigned int = 0, unsigned int = 1, unsigned int = 2,
+					unsigned int = 3);
+	void appendCandle(float, float, float, float);
+	virtual void clear();
+
+	// render
+	virtual void draw(SDL_Renderer*);
+	virtual std::string getType() const;
+};
+
+#endif
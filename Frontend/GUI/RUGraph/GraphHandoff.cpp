@@ -0,0 +1,165 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GraphHandoff.h"
+
+GraphHandoff::GraphHandoff(unsigned int newQueueSize)
+{
+	backIndex = 0;
+	latestIndex = 1;
+	frontIndex = 2;
+	for (unsigned int i = 0; i < 3; ++i)
+		appendMarks[i] = 0;
+
+	// round the ring up to a power of two so positions wrap with a mask
+	queueSize = 1;
+	while (queueSize < newQueueSize)
+		queueSize <<= 1;
+	queueMask = queueSize - 1;
+	queueHead = 0;
+	queueTail = 0;
+}
+
+GraphHandoff::~GraphHandoff()
+{
+	queueHead = 0;
+	queueTail = 0;
+}
+
+int GraphHandoff::exchange(volatile int* slot, int newValue)
+{
+	// full barrier on both sides, unlike __sync_lock_test_and_set
+	int oldValue = *slot;
+	while (true)
+	{
+		int seenValue = __sync_val_compare_and_swap(slot, oldValue, newValue);
+		if (seenValue == oldValue)
+			return oldValue;
+		oldValue = seenValue;
+	}
+}
+
+/*!
+ * @brief get the back buffer
+ * @details the snapshot the producer fills before calling publish. It is owned by the producer
+ * until then and may still hold an older snapshot.
+ * @return the back buffer
+ */
+GraphSeries& GraphHandoff::getBackBuffer()
+{
+	return buffers[backIndex];
+}
+
+/*!
+ * @brief publish
+ * @details hands the back buffer to the renderer. Samples appended before this point belong to
+ * older data and are skipped by the renderer.
+ */
+void GraphHandoff::publish()
+{
+	appendMarks[backIndex] = queueTail;
+	backIndex = exchange(&latestIndex, backIndex | FRESH) & INDEX_MASK;
+}
+
+/*!
+ * @brief append
+ * @details queues samples for the renderer without waiting on it
+ * @param xValues the x column
+ * @param yValues the y column
+ * @param count the number of samples in each column
+ * @return the number of samples queued, fewer than count when the renderer is a full ring behind
+ */
+unsigned int GraphHandoff::append(const float* xValues, const float* yValues, unsigned int count)
+{
+	if ((!xValues) || (!yValues))
+		return 0;
+
+	// series that are only ever set do not pay for the ring
+	if (queueX.empty())
+	{
+		queueX.resize(queueSize);
+		queueY.resize(queueSize);
+	}
+
+	unsigned int tail = queueTail;
+	__sync_synchronize();
+	unsigned int space = queueSize - (tail - queueHead);
+	if (count > space)
+		count = space;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int pos = (tail + i) & queueMask;
+		queueX[pos] = xValues[i];
+		queueY[pos] = yValues[i];
+	}
+
+	// the samples are written before the new tail is visible
+	__sync_synchronize();
+	queueTail = tail + count;
+	return count;
+}
+
+/*!
+ * @brief acquire
+ * @details takes the newest published snapshot, if there is one since the last call. Samples
+ * queued before that snapshot are dropped.
+ * @return the snapshot, owned by the renderer until the next acquire, or NULL
+ */
+GraphSeries* GraphHandoff::acquire()
+{
+	if (!(latestIndex & FRESH))
+		return NULL;
+
+	frontIndex = exchange(&latestIndex, frontIndex) & INDEX_MASK;
+	__sync_synchronize();
+
+	// skip the samples that the snapshot replaced
+	unsigned int mark = appendMarks[frontIndex];
+	if ((int)(mark - queueHead) > 0)
+		queueHead = mark;
+
+	return &buffers[frontIndex];
+}
+
+unsigned int GraphHandoff::pending() const
+{
+	unsigned int tail = queueTail;
+	__sync_synchronize();
+	return tail - queueHead;
+}
+
+/*!
+ * @brief drain
+ * @details copies the oldest queued samples out of the ring and frees their slots
+ * @param xValues the x column to fill
+ * @param yValues the y column to fill
+ * @param count the number of samples, at most pending()
+ */
+void GraphHandoff::drain(float* xValues, float* yValues, unsigned int count)
+{
+	unsigned int head = queueHead;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int pos = (head + i) & queueMask;
+		xValues[i] = queueX[pos];
+		yValues[i] = queueY[pos];
+	}
+
+	// the slots are read before the producer may reuse them
+	__sync_synchronize();
+	queueHead = head + count;
+}
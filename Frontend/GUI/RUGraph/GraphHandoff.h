@@ -0,0 +1,76 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GRAPHHANDOFF_H
+#define _GRAPHHANDOFF_H
+
+#include "GraphSeries.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief GraphHandoff
+ * @details Lock-free handoff of series data from one producer thread to the render thread.
+ * Whole snapshots go through a triple buffer: the producer fills its back buffer and swaps it
+ * with the shared latest slot, the renderer swaps the latest slot with its front buffer at frame
+ * start. Neither side waits and snapshots published between two frames are coalesced into the
+ * newest one. Appended samples go through a single producer, single consumer ring that the
+ * renderer drains each frame. Only one producer may touch the handoff at a time; Graphable
+ * serializes its producers with a mutex the renderer never takes.
+ */
+
+class GraphHandoff
+{
+private:
+	static const int FRESH = 4;
+	static const int INDEX_MASK = 3;
+
+	GraphSeries buffers[3];
+	unsigned int appendMarks[3];
+	int backIndex;
+	int frontIndex;
+	volatile int latestIndex;
+
+	// sample ring, written by the producer and drained by the renderer
+	std::vector<float> queueX;
+	std::vector<float> queueY;
+	unsigned int queueSize;
+	unsigned int queueMask;
+	volatile unsigned int queueHead;
+	volatile unsigned int queueTail;
+
+	static int exchange(volatile int*, int);
+
+public:
+	static const unsigned int DEFAULT_QUEUE_SIZE = 16384;
+
+	// constructors & destructor
+	GraphHandoff(unsigned int = DEFAULT_QUEUE_SIZE);
+	~GraphHandoff();
+
+	// producer
+	GraphSeries& getBackBuffer();
+	void publish();
+	unsigned int append(const float*, const float*, unsigned int);
+
+	// renderer
+	GraphSeries* acquire();
+	unsigned int pending() const;
+	void drain(float*, float*, unsigned int);
+};
+
+#endif
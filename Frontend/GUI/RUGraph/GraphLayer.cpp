@@ -0,0 +1,130 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GraphLayer.h"
+
+GraphLayer::GraphLayer(bool startDirty)
+{
+	texture = NULL;
+	prevTarget = NULL;
+	width = 0;
+	height = 0;
+	dirty = startDirty;
+}
+
+GraphLayer::~GraphLayer()
+{
+	release();
+}
+
+SDL_Texture* GraphLayer::getTexture() const
+{
+	return texture;
+}
+
+/*!
+ * @brief needs update
+ * @details whether the layer has to be re-rasterized before it is composited
+ * @param newWidth the current graph width
+ * @param newHeight the current graph height
+ * @return true if the layer was invalidated or no longer matches the graph size
+ */
+bool GraphLayer::needsUpdate(int newWidth, int newHeight) const
+{
+	if (dirty)
+		return true;
+
+	// a layer that was never drawn stays empty until it is invalidated
+	if (!texture)
+		return false;
+
+	return (width != newWidth) || (height != newHeight);
+}
+
+void GraphLayer::invalidate()
+{
+	dirty = true;
+}
+
+void GraphLayer::release()
+{
+	if (texture)
+		SDL_DestroyTexture(texture);
+
+	texture = NULL;
+	prevTarget = NULL;
+	width = 0;
+	height = 0;
+	dirty = true;
+}
+
+/*!
+ * @brief begin
+ * @details makes the layer the render target and clears it to transparent. The previous render
+ * target is restored by end.
+ * @param renderer the renderer
+ * @param newWidth the layer width
+ * @param newHeight the layer height
+ * @return false if the layer texture could not be created
+ */
+bool GraphLayer::begin(SDL_Renderer* renderer, int newWidth, int newHeight)
+{
+	if ((!renderer) || (newWidth <= 0) || (newHeight <= 0))
+		return false;
+
+	// match the graph size
+	if ((texture) && ((width != newWidth) || (height != newHeight)))
+	{
+		SDL_DestroyTexture(texture);
+		texture = NULL;
+	}
+
+	if (!texture)
+	{
+		texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+									newWidth, newHeight);
+		if (!texture)
+			return false;
+
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		width = newWidth;
+		height = newHeight;
+	}
+
+	prevTarget = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, texture);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(renderer);
+	return true;
+}
+
+void GraphLayer::end(SDL_Renderer* renderer)
+{
+	if (!renderer)
+		return;
+
+	SDL_SetRenderTarget(renderer, prevTarget);
+	prevTarget = NULL;
+	dirty = false;
+}
+
+void GraphLayer::draw(SDL_Renderer* renderer) const
+{
+	if ((!renderer) || (!texture))
+		return;
+
+	SDL_RenderCopy(renderer, texture, NULL, NULL);
+}
@@ -0,0 +1,58 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GRAPHLAYER_H
+#define _GRAPHLAYER_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*!
+ * @brief GraphLayer
+ * @details A cached, transparent render target the size of its graph. A layer is only
+ * re-rasterized after it is invalidated; otherwise compositing it is a single texture copy.
+ */
+
+class GraphLayer
+{
+private:
+	SDL_Texture* texture;
+	SDL_Texture* prevTarget;
+	int width;
+	int height;
+	bool dirty;
+
+public:
+	// constructors & destructor
+	GraphLayer(bool = true);
+	~GraphLayer();
+
+	// gets
+	SDL_Texture* getTexture() const;
+	bool needsUpdate(int, int) const;
+
+	// sets
+	void invalidate();
+	void release();
+
+	// render
+	bool begin(SDL_Renderer*, int, int);
+	void end(SDL_Renderer*);
+	void draw(SDL_Renderer*) const;
+};
+
+#endif
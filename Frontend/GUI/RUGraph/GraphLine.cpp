@@ -18,6 +18,8 @@
 #include "../../GFXUtilities/point2.h"
 #include "../../GItems/RUColors.h"
 #include "RUGraph.h"
+#include <algorithm>
+#include <math.h>
 
 GraphLine::GraphLine(RUGraph* newParent, SDL_Color newColor) : Graphable(newParent, newColor)
 {
@@ -29,45 +31,147 @@ GraphLine::~GraphLine()
 	// put code here to destroy private GraphLine variables
 }
 
+/*!
+ * @brief draw
+ * @details draws the part of the line inside the graph view. When there are more points than
+ * pixels the line is drawn one pixel column at a time from the y pyramid, so the cost follows the
+ * graph width instead of the length of the series.
+ * @param renderer the renderer
+ */
 void GraphLine::draw(SDL_Renderer* renderer)
 {
+	const unsigned int pointCount = points.size();
+	if (pointCount < 2)
+		return;
+
+	const int width = parent->getWidth();
+	if (width <= 0)
+		return;
+
 	SDL_SetRenderDrawColor(renderer, getColor().r, getColor().g, getColor().b, getColor().a);
 
-	float xRange = (float)points.size(); // points per x axis
+	// the view in points, the x axis is the point index
+	double viewFirst = parent->getViewStart() * pointCount;
+	double viewSpan = (parent->getViewEnd() - parent->getViewStart()) * pointCount;
 	float yRange = y_max - y_min;
 
-	float pointXGap = ((float)parent->getWidth()) / xRange;
+	float pointXGap = (float)(width / viewSpan);
 	float pointYGap = ((float)parent->getHeight()) / yRange;
 
-	Point2* cPoint = NULL;
-	Point2* prevPoint = NULL;
-	for (unsigned int i = 0; i < points.size(); ++i)
+	// the visible points and one past the right edge
+	unsigned int first = (unsigned int)viewFirst;
+	unsigned int last = (unsigned int)ceil(viewFirst + viewSpan) + 1;
+	if (last > pointCount)
+		last = pointCount;
+
+	if (last - first <= ((unsigned int)width) * DECIMATE_POINTS)
+		toScreenPoints(first, last - first, viewFirst, pointXGap, pointYGap, true);
+	else
+		toColumnPoints(viewFirst, viewSpan, pointYGap);
+
+	const unsigned int count = screenPoints.size();
+	if (count < 2)
+		return;
+	SDL_Point* screen = &screenPoints[0];
+
+	// draw a thick line through every point, one pixel above and below the center line
+	for (unsigned int i = 0; i < count; ++i)
+		--screen[i].y;
+	SDL_RenderDrawLines(renderer, screen, count);
+
+	for (unsigned int i = 0; i < count; ++i)
+		++screen[i].y;
+	SDL_RenderDrawLines(renderer, screen, count);
+
+	for (unsigned int i = 0; i < count; ++i)
+		++screen[i].y;
+	SDL_RenderDrawLines(renderer, screen, count);
+}
+
+/*!
+ * @brief transform the view to pixel columns
+ * @details fills screenPoints with the low and high y of the points behind each pixel column,
+ * each looked up in O(log n). The line runs through the ends in the order that keeps it closest
+ * to the previous column.
+ * @param viewFirst the point index at the left edge of the graph
+ * @param viewSpan the number of points across the graph
+ * @param pointYGap pixels per y unit
+ */
+void GraphLine::toColumnPoints(double viewFirst, double viewSpan, float pointYGap)
+{
+	const int width = parent->getWidth();
+	const unsigned int pointCount = yPyramid.size();
+	const int originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+	const double pointsPerColumn = viewSpan / width;
+
+	screenPoints.clear();
+	for (int col = 0; col < width; ++col)
 	{
-		float newXValue = i * pointXGap;
-		float newYValue = (points[i]->getY() - y_min) * pointYGap;
-		// add it to the background
-		cPoint = new Point2(parent->getAxisOriginX() + newXValue,
-							parent->getAxisOriginY() + parent->getHeight() - newYValue);
-
-		// draw a thick line from the previous to the current point
-		if ((prevPoint) && (i > 0))
-		{
-			SDL_RenderDrawLine(renderer, prevPoint->getX(), prevPoint->getY() - 1, cPoint->getX(),
-							   cPoint->getY() - 1);
-			SDL_RenderDrawLine(renderer, prevPoint->getX(), prevPoint->getY(), cPoint->getX(),
-							   cPoint->getY());
-			SDL_RenderDrawLine(renderer, prevPoint->getX(), prevPoint->getY() + 1, cPoint->getX(),
-							   cPoint->getY() + 1);
-		}
-
-		// save the previous point for later
-		if (prevPoint)
-			delete prevPoint;
-		prevPoint = cPoint;
+		unsigned int start = (unsigned int)(viewFirst + (col * pointsPerColumn));
+		unsigned int end = (unsigned int)(viewFirst + ((col + 1) * pointsPerColumn));
+		if (end <= start)
+			end = start + 1;
+		if (end > pointCount)
+			end = pointCount;
+
+		float lowValue, highValue;
+		if (!yPyramid.getRange(start, end, lowValue, highValue))
+			break;
+
+		SDL_Point low, high;
+		low.x = originX + col;
+		low.y = baseY - ((lowValue - y_min) * pointYGap);
+		high.x = low.x;
+		high.y = baseY - ((highValue - y_min) * pointYGap);
+
+		// enter the column at the end nearest the last one
+		if ((!screenPoints.empty()) && (screenPoints.back().y < ((low.y + high.y) / 2)))
+			std::swap(low, high);
+
+		screenPoints.push_back(low);
+		if (high.y != low.y)
+			screenPoints.push_back(high);
 	}
+}
+
+/*!
+ * @brief find the nearest point
+ * @details the x axis is the point index, so the point under the mouse is found directly from the
+ * view and the nearest one is a neighbor of it
+ */
+bool GraphLine::findNearest(int mouseX, int mouseY, Point2& value, SDL_Point& screenPoint,
+							float& distance)
+{
+	const unsigned int pointCount = points.size();
+	const int width = parent->getWidth();
+	if ((pointCount == 0) || (width <= 0))
+		return false;
+
+	double viewFirst = parent->getViewStart() * pointCount;
+	double viewSpan = (parent->getViewEnd() - parent->getViewStart()) * pointCount;
+	double pointXGap = width / viewSpan;
+	float yRange = y_max - y_min;
+	float pointYGap = (yRange > 0.0f) ? ((float)parent->getHeight()) / yRange : 0.0f;
+	const int originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+
+	double position = viewFirst + ((mouseX - originX) / pointXGap);
+	if (position < 0.0)
+		position = 0.0;
+
+	unsigned int index = (unsigned int)(position + 0.5);
+	if (index >= pointCount)
+		index = pointCount - 1;
+	value.set(points.getX(index), points.getY(index));
+
+	screenPoint.x = originX + (int)((index - viewFirst) * pointXGap);
+	screenPoint.y = baseY - ((points.getY(index) - y_min) * pointYGap);
 
-	if (cPoint)
-		delete cPoint;
+	float deltaX = (float)(screenPoint.x - mouseX);
+	float deltaY = (float)(screenPoint.y - mouseY);
+	distance = sqrtf((deltaX * deltaX) + (deltaY * deltaY));
+	return true;
 }
 
 std::string GraphLine::getType() const
@@ -32,7 +32,16 @@ class Point2;
 
 class GraphLine : public Graphable
 {
+private:
+	void toColumnPoints(double, double, float);
+
+protected:
+	virtual bool findNearest(int, int, Point2&, SDL_Point&, float&);
+
 public:
+	// draw a pixel column at a time past this many visible points per pixel
+	static const unsigned int DECIMATE_POINTS = 2;
+
 	// constructors & destructor
 	GraphLine(RUGraph*, SDL_Color = RUColors::DEFAULT_COLOR_LINE);
 	~GraphLine();
@@ -16,52 +16,381 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "GraphScatter.h"
+#include "../../GFXUtilities/WorkerPool.h"
 #include "../../GFXUtilities/point2.h"
 #include "../../GItems/RUColors.h"
 #include "RUGraph.h"
+#include <string.h>
+
+/*!
+ * @brief DensityBinJob
+ * @details bins one slice of the points into that task's partial grid
+ */
+class DensityBinJob : public WorkerJob
+{
+public:
+	const float* xData;
+	const float* yData;
+	unsigned int pointCount;
+	unsigned int taskCount;
+	std::vector<std::vector<unsigned int> >* grids;
+	int width, height;
+	float originX, baseY, xMin, yMin, xGap, yGap;
+
+	virtual void run(unsigned int task)
+	{
+		std::vector<unsigned int>& grid = (*grids)[task];
+		memset(&grid[0], 0, grid.size() * sizeof(unsigned int));
+
+		unsigned int start = (unsigned int)(((unsigned long)pointCount * task) / taskCount);
+		unsigned int end = (unsigned int)(((unsigned long)pointCount * (task + 1)) / taskCount);
+		for (unsigned int i = start; i < end; ++i)
+		{
+			float fx = originX + ((xData[i] - xMin) * xGap);
+			if (fx < 0.0f)
+				continue;
+
+			int px = (int)fx;
+			int py = (int)(baseY - ((yData[i] - yMin) * yGap));
+
+			// the bottom edge belongs to the last row
+			if (py == height)
+				--py;
+
+			if ((px < 0) || (py < 0) || (px >= width) || (py >= height))
+				continue;
+
+			++grid[(py * width) + px];
+		}
+	}
+};
+
+/*!
+ * @brief DensityReduceJob
+ * @details sums the partial grids for one band of rows and colors it
+ */
+class DensityReduceJob : public WorkerJob
+{
+public:
+	std::vector<std::vector<unsigned int> >* grids;
+	unsigned int gridCount;
+	unsigned int* counts;
+	unsigned int* bandMax;
+	unsigned int pixelCount;
+	unsigned int bandCount;
+
+	virtual void run(unsigned int band)
+	{
+		unsigned int start = (unsigned int)(((unsigned long)pixelCount * band) / bandCount);
+		unsigned int end = (unsigned int)(((unsigned long)pixelCount * (band + 1)) / bandCount);
+
+		unsigned int maxCount = 0;
+		const unsigned int* first = &(*grids)[0][0];
+		for (unsigned int i = start; i < end; ++i)
+			counts[i] = first[i];
+
+		for (unsigned int g = 1; g < gridCount; ++g)
+		{
+			const unsigned int* partial = &(*grids)[g][0];
+			for (unsigned int i = start; i < end; ++i)
+				counts[i] += partial[i];
+		}
+
+		for (unsigned int i = start; i < end; ++i)
+		{
+			if (counts[i] > maxCount)
+				maxCount = counts[i];
+		}
+
+		bandMax[band] = maxCount;
+	}
+};
+
+/*!
+ * @brief DensityColorJob
+ * @details maps one band of counts to colors on a log scale
+ */
+class DensityColorJob : public WorkerJob
+{
+public:
+	const unsigned int* counts;
+	Uint32* pixels;
+	const Colormap* colormap;
+	unsigned int maxCount;
+	unsigned int pixelCount;
+	unsigned int bandCount;
+
+	virtual void run(unsigned int band)
+	{
+		unsigned int start = (unsigned int)(((unsigned long)pixelCount * band) / bandCount);
+		unsigned int end = (unsigned int)(((unsigned long)pixelCount * (band + 1)) / bandCount);
+		colormap->mapCounts(&counts[start], end - start, &pixels[start], maxCount, true);
+	}
+};
 
 GraphScatter::GraphScatter(RUGraph* newParent, SDL_Color newColor, int pointSz)
-	: Graphable(newParent, newColor)
+	: Graphable(newParent, newColor), densityColormap(Colormap::VIRIDIS)
 {
 	pointSize = pointSz;
+	outlineRadius = -1;
+	densityMode = false;
+	densityTexture = NULL;
+	densityWidth = 0;
+	densityHeight = 0;
+
+	// hover and brush queries
+	gridIndexed = true;
 }
 
 GraphScatter::~GraphScatter()
 {
 	pointSize = 0;
+	outlineRadius = -1;
+	densityMode = false;
+
+	if (densityTexture)
+		SDL_DestroyTexture(densityTexture);
+	densityTexture = NULL;
+}
+
+bool GraphScatter::getDensityMode() const
+{
+	return densityMode;
+}
+
+/*!
+ * @brief set density mode
+ * @details draws the points as a per-pixel density map instead of one outline per point, so the
+ * cost follows the pixel count instead of the point count
+ * @param newDensityMode true for the density map
+ */
+void GraphScatter::setDensityMode(bool newDensityMode)
+{
+	densityMode = newDensityMode;
+	invalidate();
+}
+
+int GraphScatter::getDensityColormap() const
+{
+	return densityColormap.getType();
+}
+
+/*!
+ * @brief set the density colormap
+ * @param newColormap a Colormap type, VIRIDIS by default
+ */
+void GraphScatter::setDensityColormap(int newColormap)
+{
+	densityColormap.setType(newColormap);
+	invalidate();
 }
 
 void GraphScatter::draw(SDL_Renderer* renderer)
 {
+	// the highlight follows the points
+	selectionLayer.invalidate();
+
+	if (points.empty())
+		return;
+
+	if (densityMode)
+	{
+		drawDensity(renderer);
+		return;
+	}
+
 	SDL_SetRenderDrawColor(renderer, getColor().r, getColor().g, getColor().b, getColor().a);
 
 	// draw the line
-	float xRange = (x_max - x_min) * 1.000001;
+	float viewMin, viewMax;
+	getViewX(viewMin, viewMax);
+	float xRange = (viewMax - viewMin) * 1.000001;
 	float yRange = y_max - y_min;
 	float pointXGap = ((float)parent->getWidth()) / xRange;
 	float pointYGap = ((float)parent->getHeight()) / yRange;
 
-	Point2* cPoint = NULL;
-	Point2* prevPoint = NULL;
-	for (unsigned int i = 0; i < points.size(); ++i)
+	// transform the whole series at once
+	toScreenPoints(0, points.size(), viewMin, pointXGap, pointYGap);
+
+	// stamp the outline of every point into one batch
+	buildOutline(pointSize / 2);
+	const unsigned int outlineSize = outline.size();
+	if (outlineSize == 0)
+		return;
+
+	batch.clear();
+	for (unsigned int i = 0; i < screenPoints.size(); ++i)
+	{
+		const SDL_Point& cPoint = screenPoints[i];
+		if (cPoint.x < 0 || cPoint.y < 0)
+			continue;
+
+		for (unsigned int j = 0; j < outlineSize; ++j)
+		{
+			SDL_Point stamp;
+			stamp.x = cPoint.x + outline[j].x;
+			stamp.y = cPoint.y + outline[j].y;
+			batch.push_back(stamp);
+		}
+
+		// flush a full batch
+		if (batch.size() >= BATCH_SIZE)
+		{
+			SDL_RenderDrawPoints(renderer, &batch[0], batch.size());
+			batch.clear();
+		}
+	}
+
+	if (!batch.empty())
+		SDL_RenderDrawPoints(renderer, &batch[0], batch.size());
+}
+
+/*!
+ * @brief draw the density map
+ * @details bins every point into per-thread grids at the graph resolution, reduces them into one
+ * grid of counts, colors the counts and uploads them as a single streaming texture
+ * @param renderer the renderer
+ */
+void GraphScatter::drawDensity(SDL_Renderer* renderer)
+{
+	const int width = parent->getWidth();
+	const int height = parent->getHeight();
+	const unsigned int pixelCount = width * height;
+	if (pixelCount == 0)
+		return;
+
+	WorkerPool* pool = WorkerPool::getSharedPool();
+	const unsigned int pointCount = points.size();
+
+	// one partial grid per task
+	unsigned int taskCount = (pointCount / DENSITY_TASK_POINTS) + 1;
+	if (taskCount > pool->size())
+		taskCount = pool->size();
+
+	if (partialGrids.size() < taskCount)
+		partialGrids.resize(taskCount);
+	for (unsigned int i = 0; i < taskCount; ++i)
+		partialGrids[i].resize(pixelCount);
+
+	float viewMin, viewMax;
+	getViewX(viewMin, viewMax);
+	float xRange = (viewMax - viewMin) * 1.000001;
+	float yRange = y_max - y_min;
+
+	DensityBinJob binJob;
+	binJob.xData = points.getXData();
+	binJob.yData = points.getYData();
+	binJob.pointCount = pointCount;
+	binJob.taskCount = taskCount;
+	binJob.grids = &partialGrids;
+	binJob.width = width;
+	binJob.height = height;
+	binJob.originX = parent->getAxisOriginX();
+	binJob.baseY = parent->getAxisOriginY() + height;
+	binJob.xMin = viewMin;
+	binJob.yMin = y_min;
+	binJob.xGap = (xRange > 0.0f) ? ((float)width) / xRange : 0.0f;
+	binJob.yGap = (yRange > 0.0f) ? ((float)height) / yRange : 0.0f;
+	pool->run(&binJob, taskCount);
+
+	// reduce and color in bands of rows
+	unsigned int bandCount = pool->size();
+	densityGrid.resize(pixelCount);
+	densityPixels.resize(pixelCount);
+	bandMax.resize(bandCount);
+
+	DensityReduceJob reduceJob;
+	reduceJob.grids = &partialGrids;
+	reduceJob.gridCount = taskCount;
+	reduceJob.counts = &densityGrid[0];
+	reduceJob.bandMax = &bandMax[0];
+	reduceJob.pixelCount = pixelCount;
+	reduceJob.bandCount = bandCount;
+	pool->run(&reduceJob, bandCount);
+
+	unsigned int maxCount = 0;
+	for (unsigned int i = 0; i < bandCount; ++i)
 	{
-		float newXValue = (points[i]->getX() - x_min) * pointXGap;
-		float newYValue = (points[i]->getY() - y_min) * pointYGap;
+		if (bandMax[i] > maxCount)
+			maxCount = bandMax[i];
+	}
 
-		// add it to the background
-		cPoint = new Point2(parent->getAxisOriginX() + newXValue,
-							parent->getAxisOriginY() + parent->getHeight() - newYValue);
+	if (maxCount == 0)
+		return;
 
-		drawPointOutline(renderer, cPoint->getX(), cPoint->getY());
+	DensityColorJob colorJob;
+	colorJob.counts = &densityGrid[0];
+	colorJob.pixels = &densityPixels[0];
+	colorJob.colormap = &densityColormap;
+	colorJob.maxCount = maxCount;
+	colorJob.pixelCount = pixelCount;
+	colorJob.bandCount = bandCount;
+	pool->run(&colorJob, bandCount);
 
-		// save the previous point for later
-		if (prevPoint)
-			delete prevPoint;
-		prevPoint = cPoint;
+	// match the graph size
+	if ((densityTexture) && ((densityWidth != width) || (densityHeight != height)))
+	{
+		SDL_DestroyTexture(densityTexture);
+		densityTexture = NULL;
 	}
 
-	if (cPoint)
-		delete cPoint;
+	if (!densityTexture)
+	{
+		densityTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+										   SDL_TEXTUREACCESS_STREAMING, width, height);
+		if (!densityTexture)
+			return;
+
+		SDL_SetTextureBlendMode(densityTexture, SDL_BLENDMODE_BLEND);
+		densityWidth = width;
+		densityHeight = height;
+	}
+
+	SDL_UpdateTexture(densityTexture, NULL, &densityPixels[0], width * sizeof(Uint32));
+	SDL_RenderCopy(renderer, densityTexture, NULL, NULL);
+}
+
+/*!
+ * @brief build the point outline
+ * @details caches the offsets of a midpoint circle outline so every point can reuse them
+ * @param r the outline radius
+ */
+void GraphScatter::buildOutline(int r)
+{
+	if (r == outlineRadius)
+		return;
+
+	outline.clear();
+	outlineRadius = r;
+	if (r <= 0)
+		return;
+
+	int x = r - 1, y = 0, dx = 1, dy = 1, err = dx - (r << 1);
+	while (x >= y)
+	{
+		const int offsets[8][2] = {{x, y},   {y, x},   {-y, x}, {-x, y},
+								   {-x, -y}, {-y, -x}, {y, -x}, {x, -y}};
+		for (int i = 0; i < 8; ++i)
+		{
+			SDL_Point offset;
+			offset.x = offsets[i][0];
+			offset.y = offsets[i][1];
+			outline.push_back(offset);
+		}
+
+		if (err <= 0)
+		{
+			++y;
+			err += dy;
+			dy += 2;
+		}
+		if (err > 0)
+		{
+			--x;
+			dx += 2;
+			err += dx - (r << 1);
+		}
+	}
 }
 
 void GraphScatter::drawPointOutline(SDL_Renderer* renderer, int cx, int cy, int r)
@@ -114,6 +443,224 @@ void GraphScatter::drawPoint(SDL_Renderer* renderer, int cx, int cy, int r)
 		drawPointOutline(renderer, cx, cy, i);
 }
 
+/*!
+ * @brief find the nearest point
+ * @details turns the mouse position into data coordinates and searches the point grid, with the
+ * axes scaled to pixels so the nearest point on screen is found
+ */
+bool GraphScatter::findNearest(int mouseX, int mouseY, Point2& value, SDL_Point& screenPoint,
+							   float& distance)
+{
+	if (points.empty())
+		return false;
+
+	float viewMin, viewMax;
+	getViewX(viewMin, viewMax);
+	float xRange = (viewMax - viewMin) * 1.000001;
+	float yRange = y_max - y_min;
+	float pointXGap = (xRange > 0.0f) ? ((float)parent->getWidth()) / xRange : 0.0f;
+	float pointYGap = (yRange > 0.0f) ? ((float)parent->getHeight()) / yRange : 0.0f;
+	const float originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+
+	float x = viewMin + ((pointXGap > 0.0f) ? (mouseX - originX) / pointXGap : 0.0f);
+	float y = y_min + ((pointYGap > 0.0f) ? (baseY - mouseY) / pointYGap : 0.0f);
+	unsigned int index = 0;
+	if (!pointGrid.nearest(points.getXData(), points.getYData(), x, y, pointXGap, pointYGap, index,
+						   distance))
+		return false;
+
+	value.set(points.getX(index), points.getY(index));
+	screenPoint.x = originX + ((points.getX(index) - viewMin) * pointXGap);
+	screenPoint.y = baseY - ((points.getY(index) - y_min) * pointYGap);
+	return true;
+}
+
+/*!
+ * @brief find the points in a rectangle
+ * @details turns the rectangle into data coordinates and queries the point grid
+ */
+bool GraphScatter::findInRect(int x1, int y1, int x2, int y2, std::vector<unsigned int>& indices)
+{
+	if (points.empty())
+		return true;
+
+	float viewMin, viewMax;
+	getViewX(viewMin, viewMax);
+	float xRange = (viewMax - viewMin) * 1.000001;
+	float yRange = y_max - y_min;
+	float pointXGap = (xRange > 0.0f) ? ((float)parent->getWidth()) / xRange : 0.0f;
+	float pointYGap = (yRange > 0.0f) ? ((float)parent->getHeight()) / yRange : 0.0f;
+	if ((pointXGap == 0.0f) || (pointYGap == 0.0f))
+		return true;
+
+	const float originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+
+	// screen y grows down
+	float left = viewMin + ((x1 - originX) / pointXGap);
+	float right = viewMin + ((x2 - originX) / pointXGap);
+	float bottom = y_min + ((baseY - y2) / pointYGap);
+	float top = y_min + ((baseY - y1) / pointYGap);
+	pointGrid.query(points.getXData(), points.getYData(), left, bottom, right, top, indices);
+	return true;
+}
+
+/*!
+ * @brief get the selection
+ * @return one bit per point of the series, set for the selected points
+ */
+Bitset GraphScatter::getSelection()
+{
+	pthread_mutex_lock(plotMutex);
+	Bitset cSelection = selection;
+	pthread_mutex_unlock(plotMutex);
+
+	return cSelection;
+}
+
+/*!
+ * @brief get the selected indices
+ * @return the indices of the selected points in ascending order
+ */
+std::vector<unsigned int> GraphScatter::getSelectedIndices()
+{
+	pthread_mutex_lock(plotMutex);
+	std::vector<unsigned int> cIndices = selectedIndices;
+	pthread_mutex_unlock(plotMutex);
+
+	return cIndices;
+}
+
+/*!
+ * @brief select a rectangle
+ * @details replaces the selection with the points drawn inside a rectangle, found through the
+ * point grid. Only the highlight layer is redrawn.
+ * @param x1 one corner x in graph coordinates
+ * @param y1 one corner y in graph coordinates
+ * @param x2 the opposite corner x in graph coordinates
+ * @param y2 the opposite corner y in graph coordinates
+ * @return the number of points selected
+ */
+unsigned int GraphScatter::selectRect(int x1, int y1, int x2, int y2)
+{
+	std::vector<unsigned int> found;
+	getPointsInRect(x1, y1, x2, y2, found);
+
+	Bitset newSelection;
+	for (unsigned int i = 0; i < found.size(); ++i)
+		newSelection.set(found[i]);
+
+	setSelection(newSelection);
+	return found.size();
+}
+
+/*!
+ * @brief set the selection
+ * @details the indices are positions in the series as it is now, a sliding window moves them
+ * @param newSelection one bit per point, set for the selected points
+ */
+void GraphScatter::setSelection(const Bitset& newSelection)
+{
+	// walk the set bits once for the sorted indices
+	std::vector<unsigned int> newIndices;
+	newIndices.reserve(newSelection.count());
+	for (unsigned int i = newSelection.findNext(0); i != Bitset::NPOS;
+		 i = newSelection.findNext(i + 1))
+		newIndices.push_back(i);
+
+	pthread_mutex_lock(plotMutex);
+	selection = newSelection;
+	if (selection.size() < points.size())
+		selection.resize(points.size());
+	selectedIndices.swap(newIndices);
+	selectionLayer.invalidate();
+	pthread_mutex_unlock(plotMutex);
+}
+
+void GraphScatter::clearSelection()
+{
+	setSelection(Bitset());
+}
+
+/*!
+ * @brief update the data layer
+ * @details composites the highlight of the selected points over the data layer
+ * @param renderer the renderer
+ */
+void GraphScatter::updateBackground(SDL_Renderer* renderer)
+{
+	Graphable::updateBackground(renderer);
+	if (!parent || !parent->isVisible() || !(parent->getWidth() > 0 && parent->getHeight() > 0))
+		return;
+
+	pthread_mutex_lock(plotMutex);
+	bool hasSelection = !selectedIndices.empty();
+	if ((hasSelection) && (selectionLayer.needsUpdate(parent->getWidth(), parent->getHeight())))
+	{
+		if (selectionLayer.begin(renderer, parent->getWidth(), parent->getHeight()))
+		{
+			drawSelection(renderer);
+			selectionLayer.end(renderer);
+		}
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	if (hasSelection)
+		selectionLayer.draw(renderer);
+}
+
+/*!
+ * @brief draw the selection
+ * @details fills a square over every selected point in one batch
+ * @param renderer the renderer
+ */
+void GraphScatter::drawSelection(SDL_Renderer* renderer)
+{
+	float viewMin, viewMax;
+	getViewX(viewMin, viewMax);
+	float xRange = (viewMax - viewMin) * 1.000001;
+	float yRange = y_max - y_min;
+	float pointXGap = ((float)parent->getWidth()) / xRange;
+	float pointYGap = ((float)parent->getHeight()) / yRange;
+	const float originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+	const int side = (pointSize > 1) ? pointSize : 2;
+
+	highlightRects.clear();
+	for (unsigned int i = 0; i < selectedIndices.size(); ++i)
+	{
+		unsigned int index = selectedIndices[i];
+		if (index >= points.size())
+			break;
+
+		SDL_Rect highlight;
+		highlight.x = (int)(originX + ((points.getX(index) - viewMin) * pointXGap)) - (side / 2);
+		highlight.y = (int)(baseY - ((points.getY(index) - y_min) * pointYGap)) - (side / 2);
+		highlight.w = side;
+		highlight.h = side;
+		highlightRects.push_back(highlight);
+	}
+
+	if (highlightRects.empty())
+		return;
+
+	SDL_Color highlightColor = RUColors::DEFAULT_COMPONENT_HIGHLIGHT;
+	SDL_SetRenderDrawColor(renderer, highlightColor.r, highlightColor.g, highlightColor.b,
+						   highlightColor.a);
+	SDL_RenderFillRects(renderer, &highlightRects[0], highlightRects.size());
+}
+
+void GraphScatter::releaseTextures()
+{
+	if (densityTexture)
+		SDL_DestroyTexture(densityTexture);
+	densityTexture = NULL;
+	selectionLayer.release();
+
+	Graphable::releaseTextures();
+}
+
 std::string GraphScatter::getType() const
 {
 	return "GraphScatter";
@@ -25,6 +25,8 @@
 #include <string>
 #include <vector>
 
+#include "../../GFXUtilities/Bitset.h"
+#include "../../GFXUtilities/Colormap.h"
 #include "../../GItems/RUColors.h"
 #include "Graphable.h"
 
@@ -36,16 +38,64 @@ class GraphScatter : public Graphable
 private:
 	void drawPoint(SDL_Renderer*, int, int, int = 0);
 	void drawPointOutline(SDL_Renderer*, int, int, int = 0);
+	void buildOutline(int);
 	int pointSize;
 
+	// cached outline offsets and the batch they are stamped into
+	std::vector<SDL_Point> outline;
+	std::vector<SDL_Point> batch;
+	int outlineRadius;
+
+	static const unsigned int BATCH_SIZE = 8192;
+
+	// density mode, points binned into per-pixel counts
+	bool densityMode;
+	std::vector<std::vector<unsigned int> > partialGrids;
+	std::vector<unsigned int> densityGrid;
+	std::vector<unsigned int> bandMax;
+	std::vector<Uint32> densityPixels;
+	Colormap densityColormap;
+	SDL_Texture* densityTexture;
+	int densityWidth;
+	int densityHeight;
+
+	void drawDensity(SDL_Renderer*);
+
+	// brushed points, highlighted in their own layer over the data layer
+	Bitset selection;
+	std::vector<unsigned int> selectedIndices;
+	std::vector<SDL_Rect> highlightRects;
+	GraphLayer selectionLayer;
+
+	void drawSelection(SDL_Renderer*);
+
+protected:
+	virtual bool findNearest(int, int, Point2&, SDL_Point&, float&);
+	virtual bool findInRect(int, int, int, int, std::vector<unsigned int>&);
+
 public:
+	static const unsigned int DENSITY_TASK_POINTS = 65536;
+
 	// constructors & destructor
 	GraphScatter(RUGraph*, SDL_Color = RUColors::DEFAULT_COLOR_LINE, int = 4);
 	~GraphScatter();
 
 	void setPointSize(int);
 	int getPointSize(int);
+	bool getDensityMode() const;
+	int getDensityColormap() const;
+	void setDensityMode(bool);
+	void setDensityColormap(int);
+
+	// selection
+	Bitset getSelection();
+	std::vector<unsigned int> getSelectedIndices();
+	unsigned int selectRect(int, int, int, int);
+	void setSelection(const Bitset&);
+	void clearSelection();
 
+	virtual void updateBackground(SDL_Renderer*);
+	virtual void releaseTextures();
 	virtual void draw(SDL_Renderer*);
 	virtual std::string getType() const;
 };
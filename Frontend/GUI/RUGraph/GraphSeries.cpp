@@ -0,0 +1,229 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GraphSeries.h"
+#include <algorithm>
+
+GraphSeries::GraphSeries()
+{
+	windowSize = 0;
+	head = 0;
+	count = 0;
+}
+
+GraphSeries::~GraphSeries()
+{
+	clear();
+	windowSize = 0;
+}
+
+unsigned int GraphSeries::size() const
+{
+	return count;
+}
+
+unsigned int GraphSeries::capacity() const
+{
+	if (windowSize > 0)
+		return windowSize;
+
+	return xValues.capacity();
+}
+
+bool GraphSeries::empty() const
+{
+	return count == 0;
+}
+
+bool GraphSeries::full() const
+{
+	return (windowSize > 0) && (count == windowSize);
+}
+
+unsigned int GraphSeries::getWindowSize() const
+{
+	return windowSize;
+}
+
+float GraphSeries::getX(unsigned int index) const
+{
+	return xValues[head + index];
+}
+
+float GraphSeries::getY(unsigned int index) const
+{
+	return yValues[head + index];
+}
+
+const float* GraphSeries::getXData() const
+{
+	if (count == 0)
+		return NULL;
+
+	return &xValues[head];
+}
+
+const float* GraphSeries::getYData() const
+{
+	if (count == 0)
+		return NULL;
+
+	return &yValues[head];
+}
+
+void GraphSeries::reserve(unsigned int newCapacity)
+{
+	// a windowed series is already allocated
+	if (windowSize > 0)
+		return;
+
+	xValues.reserve(newCapacity);
+	yValues.reserve(newCapacity);
+}
+
+/*!
+ * @brief set the window size
+ * @details bounds the series to the newest n points, 0 makes it unbounded again. The newest
+ * points that still fit are kept.
+ * @param newWindowSize the number of points to keep
+ */
+void GraphSeries::setWindowSize(unsigned int newWindowSize)
+{
+	if (newWindowSize == windowSize)
+		return;
+
+	// keep the newest points that fit in the new window
+	unsigned int keepCount = count;
+	if ((newWindowSize > 0) && (keepCount > newWindowSize))
+		keepCount = newWindowSize;
+
+	const unsigned int keepStart = head + count - keepCount;
+	std::vector<float> keptX(xValues.begin() + keepStart, xValues.begin() + keepStart + keepCount);
+	std::vector<float> keptY(yValues.begin() + keepStart, yValues.begin() + keepStart + keepCount);
+
+	windowSize = newWindowSize;
+	head = 0;
+	count = 0;
+	if (windowSize == 0)
+	{
+		xValues.swap(keptX);
+		yValues.swap(keptY);
+		count = xValues.size();
+		return;
+	}
+
+	xValues.assign(windowSize * 2, 0.0f);
+	yValues.assign(windowSize * 2, 0.0f);
+	for (unsigned int i = 0; i < keepCount; ++i)
+		addPoint(keptX[i], keptY[i]);
+}
+
+/*!
+ * @brief clear the series
+ * @details removes every point but keeps the reserved capacity for the next fill
+ */
+void GraphSeries::clear()
+{
+	if (windowSize == 0)
+	{
+		xValues.clear();
+		yValues.clear();
+	}
+
+	head = 0;
+	count = 0;
+}
+
+/*!
+ * @brief add a point
+ * @details appends to the end of the series. A full window drops its oldest point to make room.
+ * @param newX the x value
+ * @param newY the y value
+ */
+void GraphSeries::addPoint(float newX, float newY)
+{
+	if (windowSize == 0)
+	{
+		xValues.push_back(newX);
+		yValues.push_back(newY);
+		++count;
+		return;
+	}
+
+	unsigned int pos = 0;
+	if (count < windowSize)
+	{
+		pos = (head + count) % windowSize;
+		++count;
+	}
+	else
+	{
+		// overwrite the oldest point
+		pos = head;
+		head = (head + 1) % windowSize;
+	}
+
+	// mirror the sample so [head, head + count) stays contiguous
+	xValues[pos] = newX;
+	xValues[pos + windowSize] = newX;
+	yValues[pos] = newY;
+	yValues[pos + windowSize] = newY;
+}
+
+/*!
+ * @brief set the points
+ * @details replaces the series with n points copied from the x and y columns
+ * @param newXValues the x column
+ * @param newYValues the y column
+ * @param newCount the number of points in each column
+ */
+void GraphSeries::setPoints(const float* newXValues, const float* newYValues, unsigned int newCount)
+{
+	if ((!newXValues) || (!newYValues))
+		return;
+
+	if (windowSize == 0)
+	{
+		xValues.assign(newXValues, newXValues + newCount);
+		yValues.assign(newYValues, newYValues + newCount);
+		head = 0;
+		count = newCount;
+		return;
+	}
+
+	// only the newest points fit in the window
+	unsigned int start = 0;
+	if (newCount > windowSize)
+		start = newCount - windowSize;
+
+	clear();
+	for (unsigned int i = start; i < newCount; ++i)
+		addPoint(newXValues[i], newYValues[i]);
+}
+
+/*!
+ * @brief swap
+ * @details exchanges the points and window of two series without copying
+ * @param other the series to swap with
+ */
+void GraphSeries::swap(GraphSeries& other)
+{
+	xValues.swap(other.xValues);
+	yValues.swap(other.yValues);
+	std::swap(windowSize, other.windowSize);
+	std::swap(head, other.head);
+	std::swap(count, other.count);
+}
@@ -0,0 +1,67 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GRAPHSERIES_H
+#define _GRAPHSERIES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*!
+ * @brief GraphSeries
+ * @details Column storage for the points of a Graphable. The x and y values live in two
+ * contiguous float arrays so draw loops can stream through them without a Point2 per sample.
+ * With a window size set the series becomes a sliding window over the newest samples. Each
+ * sample is written twice, at pos and pos + windowSize, so the live window is always one
+ * contiguous run starting at head and appends stay O(1) with no shifting.
+ */
+
+class GraphSeries
+{
+private:
+	std::vector<float> xValues;
+	std::vector<float> yValues;
+	unsigned int windowSize;
+	unsigned int head;
+	unsigned int count;
+
+public:
+	// constructors & destructor
+	GraphSeries();
+	~GraphSeries();
+
+	// gets
+	unsigned int size() const;
+	unsigned int capacity() const;
+	bool empty() const;
+	bool full() const;
+	unsigned int getWindowSize() const;
+	float getX(unsigned int) const;
+	float getY(unsigned int) const;
+	const float* getXData() const;
+	const float* getYData() const;
+
+	// sets
+	void reserve(unsigned int);
+	void setWindowSize(unsigned int);
+	void clear();
+	void addPoint(float, float);
+	void setPoints(const float*, const float*, unsigned int);
+	void swap(GraphSeries&);
+};
+
+#endif
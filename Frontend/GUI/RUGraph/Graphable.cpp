@@ -18,6 +18,7 @@
 #include "../../../include/Backend/Database/GList.h"
 #include "../../GFXUtilities/point2.h"
 #include "RUGraph.h"
+#include <algorithm>
 
 Graphable::Graphable(RUGraph* newParent, SDL_Color newColor)
 {
@@ -28,10 +29,24 @@ Graphable::Graphable(RUGraph* newParent, SDL_Color newColor)
 	x_min = 0.0f;
 	y_max = 0.0f;
 	y_min = 0.0f;
+	data_x_max = 0.0f;
+	data_x_min = 0.0f;
+	data_y_max = 0.0f;
+	data_y_min = 0.0f;
+	niceRanges = false;
+	rangeHysteresis = 0.0f;
+	gridIndexed = false;
+	pendingColor = 0;
+	colorPending = 0;
+	producers = 0;
 
 	// plotter mutex
 	plotMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
 	pthread_mutex_init(plotMutex, NULL);
+
+	// producer mutex
+	producerMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(producerMutex, NULL);
 }
 
 Graphable::~Graphable()
@@ -50,6 +65,10 @@ Graphable::~Graphable()
 	// plotter mutex
 	pthread_mutex_destroy(plotMutex);
 	free(plotMutex);
+
+	// producer mutex
+	pthread_mutex_destroy(producerMutex);
+	free(producerMutex);
 }
 
 SDL_Color Graphable::getColor() const
@@ -57,37 +76,199 @@ SDL_Color Graphable::getColor() const
 	return lineColor;
 }
 
+unsigned int Graphable::getWindowSize() const
+{
+	return points.getWindowSize();
+}
+
+bool Graphable::getNiceRanges() const
+{
+	return niceRanges;
+}
+
+float Graphable::getRangeHysteresis() const
+{
+	return rangeHysteresis;
+}
+
 void Graphable::setColor(SDL_Color newColor)
 {
 	lineColor = newColor;
+	layer.invalidate();
+}
+
+/*!
+ * @brief publish a color
+ * @details sets the color from a producer thread. The renderer applies it at the start of its
+ * next frame.
+ * @param newColor the series color
+ */
+void Graphable::publishColor(SDL_Color newColor)
+{
+	pendingColor = ((Uint32)newColor.r << 24) | ((Uint32)newColor.g << 16) |
+				   ((Uint32)newColor.b << 8) | (Uint32)newColor.a;
+	__sync_synchronize();
+	__sync_lock_test_and_set(&colorPending, 1);
+}
+
+/*!
+ * @brief add a producer
+ * @details a producer holds the series while it publishes outside the graph's plotMutex, so a
+ * retired series is not freed under it
+ */
+void Graphable::addProducer()
+{
+	__sync_add_and_fetch(&producers, 1);
+}
+
+void Graphable::removeProducer()
+{
+	__sync_sub_and_fetch(&producers, 1);
+}
+
+bool Graphable::hasProducers() const
+{
+	return producers > 0;
+}
+
+/*!
+ * @brief set nice ranges
+ * @details snaps the drawn axis ranges out to 1, 2, 5 multiples of the grid step
+ * @param newNiceRanges true to snap the ranges
+ */
+void Graphable::setNiceRanges(bool newNiceRanges)
+{
+	pthread_mutex_lock(plotMutex);
+	niceRanges = newNiceRanges;
+	applyAxisRanges(true);
+	layer.invalidate();
+	pthread_mutex_unlock(plotMutex);
+}
+
+/*!
+ * @brief refresh the axis ranges
+ * @details snaps the drawn ranges again after the graph's grid changed, since nice ranges
+ * depend on the graph size
+ */
+void Graphable::refreshAxisRanges()
+{
+	pthread_mutex_lock(plotMutex);
+	if (niceRanges)
+	{
+		applyAxisRanges(true);
+		layer.invalidate();
+	}
+	pthread_mutex_unlock(plotMutex);
+}
+
+/*!
+ * @brief set the range hysteresis
+ * @details the drawn ranges grow as soon as the data leaves them, but only shrink once the data
+ * covers less than (1 - hysteresis) of them. 0 follows the data exactly.
+ * @param newRangeHysteresis the fraction of the range the data may leave empty, [0, 1)
+ */
+void Graphable::setRangeHysteresis(float newRangeHysteresis)
+{
+	if (newRangeHysteresis < 0.0f)
+		newRangeHysteresis = 0.0f;
+	else if (newRangeHysteresis > 0.99f)
+		newRangeHysteresis = 0.99f;
+
+	pthread_mutex_lock(plotMutex);
+	rangeHysteresis = newRangeHysteresis;
+	pthread_mutex_unlock(plotMutex);
 }
 
+/*!
+ * @brief compute the axis ranges
+ * @details scans the whole series for its bounds. A windowed series also rebuilds its range
+ * trackers here so later appends can slide the bounds without another scan.
+ */
 void Graphable::computeAxisRanges()
 {
+	xTracker.clear();
+	yTracker.clear();
+	yPyramid.clear();
+	pointGrid.clear();
 	if (points.empty())
 		return;
-	y_max = points[0]->getY();
-	y_min = y_max;
 
-	x_max = points[0]->getX();
-	x_min = x_max;
+	const float* xData = points.getXData();
+	const float* yData = points.getYData();
+	const unsigned int count = points.size();
+	yPyramid.setValues(yData, count);
+	if (gridIndexed)
+		pointGrid.build(xData, yData, count);
+
+	data_y_max = yData[0];
+	data_y_min = data_y_max;
+
+	data_x_max = xData[0];
+	data_x_min = data_x_max;
+
+	for (unsigned int i = 1; i < count; ++i)
+		expandAxisRanges(xData[i], yData[i]);
 
-	for (unsigned int i = 1; i < points.size(); ++i)
+	if (points.getWindowSize() > 0)
 	{
-		Point2* pt = points[i];
-		float y_pt = pt->getY(), x_pt = pt->getX();
-		if (y_pt > y_max)
-			y_max = y_pt;
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			xTracker.push(xData[i]);
+			yTracker.push(yData[i]);
+		}
+	}
+
+	applyAxisRanges(true);
+}
+
+void Graphable::expandAxisRanges(float x_pt, float y_pt)
+{
+	if (y_pt > data_y_max)
+		data_y_max = y_pt;
+	if (y_pt < data_y_min)
+		data_y_min = y_pt;
 
-		else if (y_pt < y_min)
-			y_min = y_pt;
+	if (x_pt > data_x_max)
+		data_x_max = x_pt;
+	if (x_pt < data_x_min)
+		data_x_min = x_pt;
+}
 
-		if (x_pt < x_min)
-			x_min = x_pt;
+/*!
+ * @brief apply the axis ranges
+ * @details turns the raw data bounds into the drawn ranges
+ * @param reset ignore the hysteresis and take the new ranges outright
+ */
+void Graphable::applyAxisRanges(bool reset)
+{
+	applyAxisRange(data_x_min, data_x_max, x_min, x_max, reset);
+	applyAxisRange(data_y_min, data_y_max, y_min, y_max, reset);
+}
+
+void Graphable::applyAxisRange(float dataMin, float dataMax, float& rangeMin, float& rangeMax,
+							   bool reset) const
+{
+	float newMin = dataMin;
+	float newMax = dataMax;
+	if (niceRanges)
+	{
+		unsigned int tickCount = RUGraph::DEFAULT_NUM_ZONES;
+		if (parent)
+			tickCount *= parent->getGraphSize();
+		RangeTracker::niceRange(newMin, newMax, tickCount);
+	}
 
-		else if (x_pt > x_max)
-			x_max = x_pt;
+	if ((!reset) && (rangeHysteresis > 0.0f))
+	{
+		// keep the current range while the data still fills enough of it
+		bool inside = (dataMin >= rangeMin) && (dataMax <= rangeMax);
+		float span = rangeMax - rangeMin;
+		if (inside && ((newMax - newMin) >= span * (1.0f - rangeHysteresis)))
+			return;
 	}
+
+	rangeMin = newMin;
+	rangeMax = newMax;
 }
 
 void Graphable::setPoints(const std::vector<Point2*>& newPoints)
@@ -95,10 +276,28 @@ void Graphable::setPoints(const std::vector<Point2*>& newPoints)
 	if (newPoints.empty())
 		return;
 
-	pthread_mutex_lock(plotMutex);
-	points = newPoints;
-	pthread_mutex_unlock(plotMutex);
-	computeAxisRanges();
+	pthread_mutex_lock(producerMutex);
+	GraphSeries& snapshot = handoff.getBackBuffer();
+	snapshot.clear();
+	snapshot.reserve(newPoints.size());
+	for (unsigned int i = 0; i < newPoints.size(); ++i)
+	{
+		if (newPoints[i])
+			snapshot.addPoint(newPoints[i]->getX(), newPoints[i]->getY());
+	}
+	handoff.publish();
+	pthread_mutex_unlock(producerMutex);
+}
+
+void Graphable::setPoints(const float* newXValues, const float* newYValues, unsigned int count)
+{
+	if (count == 0)
+		return;
+
+	pthread_mutex_lock(producerMutex);
+	handoff.getBackBuffer().setPoints(newXValues, newYValues, count);
+	handoff.publish();
+	pthread_mutex_unlock(producerMutex);
 }
 
 void Graphable::setLine(const shmea::GList& newLine)
@@ -106,18 +305,171 @@ void Graphable::setLine(const shmea::GList& newLine)
 	if (newLine.empty())
 		return;
 
-	pthread_mutex_lock(plotMutex);
-	points.clear();
+	pthread_mutex_lock(producerMutex);
+	GraphSeries& snapshot = handoff.getBackBuffer();
+	snapshot.clear();
+	snapshot.reserve(newLine.size());
 	for (unsigned int i = 0; i < newLine.size(); ++i)
-		points.push_back(new Point2(i, newLine.getFloat(i)));
-	pthread_mutex_unlock(plotMutex);
+		snapshot.addPoint(i, newLine.getFloat(i));
+	handoff.publish();
+	pthread_mutex_unlock(producerMutex);
+}
+
+void Graphable::setWindowSize(unsigned int newWindowSize)
+{
+	pthread_mutex_lock(plotMutex);
+	points.setWindowSize(newWindowSize);
 	computeAxisRanges();
+	layer.invalidate();
+	pthread_mutex_unlock(plotMutex);
+}
+
+/*!
+ * @brief append points
+ * @details queues n points for the end of the series without waiting on the renderer
+ * @param newXValues the x column
+ * @param newYValues the y column
+ * @param count the number of points in each column
+ * @return the number of points queued, fewer than count if the renderer fell a full queue behind
+ */
+unsigned int Graphable::appendPoints(const float* newXValues, const float* newYValues,
+									 unsigned int count)
+{
+	if ((!newXValues) || (!newYValues) || (count == 0))
+		return 0;
+
+	pthread_mutex_lock(producerMutex);
+	unsigned int queued = handoff.append(newXValues, newYValues, count);
+	pthread_mutex_unlock(producerMutex);
+
+	return queued;
+}
+
+/*!
+ * @brief add points
+ * @details adds n points to the end of the series. The axis ranges grow with each new point, a
+ * windowed series slides its bounds with the range trackers and the y pyramid is updated in
+ * place, so nothing is rescanned.
+ * @param newXValues the x column
+ * @param newYValues the y column
+ * @param count the number of points in each column
+ */
+void Graphable::addPoints(const float* newXValues, const float* newYValues, unsigned int count)
+{
+	bool reset = points.empty();
+	bool windowed = (points.getWindowSize() > 0);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float x_pt = newXValues[i], y_pt = newYValues[i];
+		if (points.empty())
+		{
+			data_x_min = data_x_max = x_pt;
+			data_y_min = data_y_max = y_pt;
+		}
+
+		if (windowed)
+		{
+			// the oldest point is about to be dropped
+			if (points.full())
+			{
+				xTracker.pop();
+				yTracker.pop();
+				yPyramid.pop();
+				if (gridIndexed)
+					pointGrid.pop(points.getX(0), points.getY(0));
+			}
+
+			xTracker.push(x_pt);
+			yTracker.push(y_pt);
+		}
+		else
+			expandAxisRanges(x_pt, y_pt);
+
+		points.addPoint(x_pt, y_pt);
+		yPyramid.push(y_pt);
+		if (gridIndexed)
+			pointGrid.push(x_pt, y_pt);
+	}
+
+	if ((gridIndexed) && (pointGrid.needsRebuild()))
+		pointGrid.build(points.getXData(), points.getYData(), points.size());
+
+	if (windowed)
+	{
+		data_x_min = xTracker.getMin();
+		data_x_max = xTracker.getMax();
+		data_y_min = yTracker.getMin();
+		data_y_max = yTracker.getMax();
+	}
+
+	applyAxisRanges(reset);
+}
+
+/*!
+ * @brief update the series
+ * @details picks up the newest published snapshot and the queued points on the render thread
+ * @return true if the series changed
+ */
+bool Graphable::updateSeries()
+{
+	bool changed = false;
+	if (__sync_fetch_and_and(&colorPending, 0))
+	{
+		Uint32 packedColor = pendingColor;
+		SDL_Color newColor;
+		newColor.r = (packedColor >> 24) & 0xFF;
+		newColor.g = (packedColor >> 16) & 0xFF;
+		newColor.b = (packedColor >> 8) & 0xFF;
+		newColor.a = packedColor & 0xFF;
+		if ((newColor.r != lineColor.r) || (newColor.g != lineColor.g) ||
+			(newColor.b != lineColor.b) || (newColor.a != lineColor.a))
+		{
+			lineColor = newColor;
+			changed = true;
+		}
+	}
+
+	GraphSeries* snapshot = handoff.acquire();
+	if (snapshot)
+	{
+		// the snapshot buffer goes back to the producer holding the old points
+		if (points.getWindowSize() == 0)
+			points.swap(*snapshot);
+		else
+			points.setPoints(snapshot->getXData(), snapshot->getYData(), snapshot->size());
+		computeAxisRanges();
+		changed = true;
+	}
+
+	unsigned int count = handoff.pending();
+	if (count > 0)
+	{
+		if (appendX.size() < count)
+		{
+			appendX.resize(count);
+			appendY.resize(count);
+		}
+
+		handoff.drain(&appendX[0], &appendY[0], count);
+		addPoints(&appendX[0], &appendY[0], count);
+		changed = true;
+	}
+
+	if (changed)
+		layer.invalidate();
+
+	return changed;
 }
 
 void Graphable::clear()
 {
 	pthread_mutex_lock(plotMutex);
 	points.clear();
+	xTracker.clear();
+	yTracker.clear();
+	yPyramid.clear();
+	pointGrid.clear();
+	layer.invalidate();
 	pthread_mutex_unlock(plotMutex);
 
 	parent = NULL;
@@ -125,8 +477,34 @@ void Graphable::clear()
 	x_min = 0.0f;
 	y_max = 0.0f;
 	y_min = 0.0f;
+	data_x_max = 0.0f;
+	data_x_min = 0.0f;
+	data_y_max = 0.0f;
+	data_y_min = 0.0f;
 }
 
+void Graphable::invalidate()
+{
+	layer.invalidate();
+}
+
+/*!
+ * @brief release textures
+ * @details frees the data layer, it is rasterized again on the next draw
+ */
+void Graphable::releaseTextures()
+{
+	pthread_mutex_lock(plotMutex);
+	layer.release();
+	pthread_mutex_unlock(plotMutex);
+}
+
+/*!
+ * @brief update the data layer
+ * @details redraws the series into its own layer only when it changed, then composites the layer
+ * onto the graph
+ * @param renderer the renderer
+ */
 void Graphable::updateBackground(SDL_Renderer* renderer)
 {
 	if (!parent || !parent->isVisible() || !(parent->getWidth() > 0 && parent->getHeight() > 0))
@@ -134,6 +512,152 @@ void Graphable::updateBackground(SDL_Renderer* renderer)
 
 	// draw the line
 	pthread_mutex_lock(plotMutex);
-	draw(renderer);
+	updateSeries();
+	if (layer.needsUpdate(parent->getWidth(), parent->getHeight()))
+	{
+		if (layer.begin(renderer, parent->getWidth(), parent->getHeight()))
+		{
+			draw(renderer);
+			layer.end(renderer);
+		}
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	layer.draw(renderer);
+}
+
+/*!
+ * @brief get the nearest point
+ * @details finds the point of the series drawn closest to a position on the graph
+ * @param mouseX the x position in graph coordinates
+ * @param mouseY the y position in graph coordinates
+ * @param value set to the data coordinates of the point
+ * @param screenPoint set to the graph coordinates of the point
+ * @param distance set to the distance from the position to the point in pixels
+ * @return false if the series is empty
+ */
+bool Graphable::getNearestPoint(int mouseX, int mouseY, Point2& value, SDL_Point& screenPoint,
+								float& distance)
+{
+	if (!parent || !(parent->getWidth() > 0 && parent->getHeight() > 0))
+		return false;
+
+	pthread_mutex_lock(plotMutex);
+	bool found = findNearest(mouseX, mouseY, value, screenPoint, distance);
 	pthread_mutex_unlock(plotMutex);
+
+	return found;
+}
+
+/*!
+ * @brief get the points in a rectangle
+ * @details finds the points of the series drawn inside a rectangle on the graph
+ * @param x1 one corner x in graph coordinates
+ * @param y1 one corner y in graph coordinates
+ * @param x2 the opposite corner x in graph coordinates
+ * @param y2 the opposite corner y in graph coordinates
+ * @param indices the indices of the points are appended here, in no particular order
+ * @return false if the series cannot be queried by area
+ */
+bool Graphable::getPointsInRect(int x1, int y1, int x2, int y2, std::vector<unsigned int>& indices)
+{
+	if (!parent || !(parent->getWidth() > 0 && parent->getHeight() > 0))
+		return false;
+
+	if (x2 < x1)
+		std::swap(x1, x2);
+	if (y2 < y1)
+		std::swap(y1, y2);
+
+	pthread_mutex_lock(plotMutex);
+	bool found = findInRect(x1, y1, x2, y2, indices);
+	pthread_mutex_unlock(plotMutex);
+
+	return found;
+}
+
+/*!
+ * @brief find the nearest point
+ * @details series that can be hovered override this with a lookup in their own layout. Called
+ * with the plot mutex held.
+ * @param mouseX the x position in graph coordinates
+ * @param mouseY the y position in graph coordinates
+ * @param value set to the data coordinates of the point
+ * @param screenPoint set to the graph coordinates of the point
+ * @param distance set to the distance from the position to the point in pixels
+ * @return false if there is no point to snap to
+ */
+bool Graphable::findNearest(int mouseX, int mouseY, Point2& value, SDL_Point& screenPoint,
+							float& distance)
+{
+	return false;
+}
+
+/*!
+ * @brief find the points in a rectangle
+ * @details series that can be brushed override this with a query of their own index. Called with
+ * the plot mutex held and the corners ordered.
+ * @return false if the series cannot be queried by area
+ */
+bool Graphable::findInRect(int x1, int y1, int x2, int y2, std::vector<unsigned int>& indices)
+{
+	return false;
+}
+
+/*!
+ * @brief get the visible x range
+ * @details applies the graph view to the x range of the series
+ * @param viewMin set to the x value at the left edge of the graph
+ * @param viewMax set to the x value at the right edge of the graph
+ */
+void Graphable::getViewX(float& viewMin, float& viewMax) const
+{
+	double xRange = x_max - x_min;
+	viewMin = x_min + (parent->getViewStart() * xRange);
+	viewMax = x_min + (parent->getViewEnd() * xRange);
+}
+
+/*!
+ * @brief transform the series to screen space
+ * @details fills screenPoints with the component coordinates of a run of points in one pass over
+ * the x and y columns
+ * @param first the index of the first point
+ * @param count the number of points
+ * @param xStart the x value, or index, at the left edge of the graph
+ * @param pointXGap pixels per x unit
+ * @param pointYGap pixels per y unit
+ * @param indexedX place the points by their index instead of their x value
+ */
+void Graphable::toScreenPoints(unsigned int first, unsigned int count, double xStart,
+							   float pointXGap, float pointYGap, bool indexedX)
+{
+	if (first >= points.size())
+		count = 0;
+	else if (count > points.size() - first)
+		count = points.size() - first;
+
+	screenPoints.resize(count);
+	if (count == 0)
+		return;
+
+	const float* xData = points.getXData() + first;
+	const float* yData = points.getYData() + first;
+	const float originX = parent->getAxisOriginX();
+	const float baseY = parent->getAxisOriginY() + parent->getHeight();
+	SDL_Point* screen = &screenPoints[0];
+
+	if (indexedX)
+	{
+		const float startOffset = (float)(first - xStart);
+		for (unsigned int i = 0; i < count; ++i)
+			screen[i].x = originX + ((startOffset + i) * pointXGap);
+	}
+	else
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			screen[i].x = originX + ((xData[i] - (float)xStart) * pointXGap);
+	}
+
+	for (unsigned int i = 0; i < count; ++i)
+		screen[i].y = baseY - ((yData[i] - y_min) * pointYGap);
 }
@@ -17,6 +17,12 @@
 #ifndef _GRAPHABLE_H
 #define _GRAPHABLE_H
 
+#include "../../GFXUtilities/MinMaxPyramid.h"
+#include "../../GFXUtilities/PointGrid.h"
+#include "../../GFXUtilities/RangeTracker.h"
+#include "GraphHandoff.h"
+#include "GraphLayer.h"
+#include "GraphSeries.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
 #include <pthread.h>
@@ -35,19 +41,69 @@ class GList;
 class Graphable
 {
 protected:
-	std::vector<Point2*> points;
+	GraphSeries points;
 	float x_max, x_min, y_max, y_min;
 	RUGraph* parent;
 
+	// reused every draw so the render loop does not allocate
+	std::vector<SDL_Point> screenPoints;
+
+	// cached data layer, only redrawn after the series changes
+	GraphLayer layer;
+
+	// published by producers, picked up by the renderer
+	GraphHandoff handoff;
+
+	// drained points, reused every frame
+	std::vector<float> appendX;
+	std::vector<float> appendY;
+
+	// y bounds of any run of points, for drawing long series a pixel column at a time
+	MinMaxPyramid yPyramid;
+
+	// nearest point and rectangle queries, only kept for series that set gridIndexed
+	PointGrid pointGrid;
+	bool gridIndexed;
+
+	// held by the renderer while it reads the series
+	pthread_mutex_t* plotMutex;
+
+	virtual bool updateSeries();
+	virtual bool findNearest(int, int, Point2&, SDL_Point&, float&);
+	virtual bool findInRect(int, int, int, int, std::vector<unsigned int>&);
+
+	void getViewX(float&, float&) const;
+	void toScreenPoints(unsigned int, unsigned int, double, float, float, bool = false);
+
 private:
 	SDL_Color lineColor;
-	pthread_mutex_t* plotMutex;
+
+	// set by producers, applied by the renderer
+	volatile Uint32 pendingColor;
+	volatile int colorPending;
+
+	// producer threads still publishing to the series
+	volatile int producers;
+
+	// serializes producers on the handoff, never taken by the renderer
+	pthread_mutex_t* producerMutex;
+
+	// raw data bounds, x_min..y_max are what gets drawn
+	float data_x_max, data_x_min, data_y_max, data_y_min;
+	RangeTracker xTracker, yTracker;
+	bool niceRanges;
+	float rangeHysteresis;
 
 	void computeAxisRanges();
+	void expandAxisRanges(float, float);
+	void applyAxisRanges(bool);
+	void applyAxisRange(float, float, float&, float&, bool) const;
+	void addPoints(const float*, const float*, unsigned int);
 
 public:
 	static const int LINE = 0;
 	static const int SCATTER = 1;
+	static const int CANDLE = 2;
 
 	// constructors & destructor
 	Graphable(RUGraph*, SDL_Color);
@@ -55,16 +111,35 @@ public:
 
 	// gets
 	SDL_Color getColor() const;
+	unsigned int getWindowSize() const;
+	bool getNiceRanges() const;
+	float getRangeHysteresis() const;
+	bool getNearestPoint(int, int, Point2&, SDL_Point&, float&);
+	bool getPointsInRect(int, int, int, int, std::vector<unsigned int>&);
 
 	// sets
 	void setParent(RUGraph*);
 	void setColor(SDL_Color);
 	void setPoints(const std::vector<Point2*>&);
+	void setPoints(const float*, const float*, unsigned int);
 	void setLine(const shmea::GList&);
+	void setWindowSize(unsigned int);
+	void setNiceRanges(bool);
+	void setRangeHysteresis(float);
+	void refreshAxisRanges();
+	unsigned int appendPoints(const float*, const float*, unsigned int);
+	void publishColor(SDL_Color);
 	virtual void clear();
+	void invalidate();
+
+	// producers
+	void addProducer();
+	void removeProducer();
+	bool hasProducers() const;
 
 	// render
 	virtual void updateBackground(SDL_Renderer*);
+	virtual void releaseTextures();
 	virtual void draw(SDL_Renderer*) = 0;
 	virtual std::string getType() const = 0;
 };
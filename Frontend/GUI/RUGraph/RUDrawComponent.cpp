@@ -16,6 +16,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RUDrawComponent.h"
 #include "../../../include/Backend/Database/gtype.h"
+#include "../../GFXUtilities/Colormap.h"
 #include "../../GFXUtilities/point2.h"
 #include "../../GItems/GPanel.h"
 #include "Circle.h"
@@ -31,6 +32,11 @@ RUDrawComponent::RUDrawComponent(int newWidth, int newHeight, int newQuadrants)
 	clickMode = MODE_CIRCLES;
 	prevCircle = NULL;
 
+	// match the color of a single focus circle
+	Colormap penColormap(Colormap::HUE);
+	canvas.setPenColor(penColormap.getColor(1.0f));
+	canvas.setPenRadius(penWidth);
+
 	setBGColor(RUColors::COLOR_WHITE);
 	buildDotMatrix();
 }
@@ -41,10 +47,6 @@ RUDrawComponent::~RUDrawComponent()
 	clickMode = MODE_CIRCLES;
 
 	clear();
-
-	// plotter mutex
-	pthread_mutex_destroy(plotMutex);
-	free(plotMutex);
 }
 
 int RUDrawComponent::getMode() const
@@ -65,12 +67,21 @@ void RUDrawComponent::toggleMode()
 void RUDrawComponent::setPenWidth(float newPenWidth)
 {
 	penWidth = newPenWidth;
+
+	pthread_mutex_lock(plotMutex);
+	canvas.setPenRadius(penWidth);
+	pthread_mutex_unlock(plotMutex);
 }
 
 void RUDrawComponent::updateBackground(SDL_Renderer* renderer)
 {
-	// draw the circles
 	pthread_mutex_lock(plotMutex);
+
+	// draw the strokes
+	canvas.resize(getWidth(), getHeight());
+	canvas.draw(renderer);
+
+	// draw the circles
 	for (unsigned int i = 0; i < circles.size(); ++i)
 	{
 		Graphable* g = circles[i];
@@ -88,15 +99,50 @@ void RUDrawComponent::clear(bool toggleDraw)
 	for (it = lines.begin(); it != lines.end(); ++it)
 		delete it->second;
 	lines.clear();
-	pthread_mutex_unlock(plotMutex);
 
 	// clearCircles();
 	circles.clear();
+	prevCircle = NULL;
+
+	canvas.clear();
+	pthread_mutex_unlock(plotMutex);
 
 	if (toggleDraw)
 		drawUpdate = true;
 }
 
+/*!
+ * @brief undo
+ * @details reverts the last stroke or clear on the canvas
+ * @return whether there was anything to undo
+ */
+bool RUDrawComponent::undo()
+{
+	pthread_mutex_lock(plotMutex);
+	bool changed = canvas.undo();
+	pthread_mutex_unlock(plotMutex);
+
+	if (changed)
+		drawUpdate = true;
+	return changed;
+}
+
+/*!
+ * @brief redo
+ * @details reapplies the last undone stroke or clear on the canvas
+ * @return whether there was anything to redo
+ */
+bool RUDrawComponent::redo()
+{
+	pthread_mutex_lock(plotMutex);
+	bool changed = canvas.redo();
+	pthread_mutex_unlock(plotMutex);
+
+	if (changed)
+		drawUpdate = true;
+	return changed;
+}
+
 void RUDrawComponent::addCircle(const Point2* focalPoint, double radius)
 {
 	// printf("Circle(%f, %f, %f)\n", focalPoint->getX(), focalPoint->getY(), radius);
@@ -118,30 +164,69 @@ void RUDrawComponent::addCircle(const Point2* focalPoint, double radius)
 
 void RUDrawComponent::onMouseDown(GPanel* cPanel, int eventX, int eventY)
 {
+	// event coordinates are already local to the component
 	if (clickMode == MODE_CIRCLES)
 	{
-		// Focal Point
-		Point2* cFocalPoint = new Point2(eventX - getX(), eventY - getY());
-		addCircle(cFocalPoint, getPenWidth());
+		pthread_mutex_lock(plotMutex);
+		canvas.resize(getWidth(), getHeight());
+		canvas.beginStroke(eventX, eventY);
+		pthread_mutex_unlock(plotMutex);
+
+		drawUpdate = true;
 	}
 	else if (clickMode == MODE_NELLIPSE)
 	{
 		// Focal Point
-		Point2* cFocalPoint = new Point2(eventX - getX(), eventY - getY());
+		Point2 cFocalPoint(eventX, eventY);
 
 		// Switch the type of point we are waiting for
 		if (circles.size() == 0)
-			addCircle(cFocalPoint, getPenWidth());
+			addCircle(&cFocalPoint, getPenWidth());
 		else
 		{
 			if (prevCircle)
-				prevCircle->addFocalPoint(cFocalPoint);
+				prevCircle->addFocalPoint(&cFocalPoint);
 
 			drawUpdate = true;
 		}
 	}
 }
 
+void RUDrawComponent::onMouseUp(GPanel* cPanel, int eventX, int eventY)
+{
+	pthread_mutex_lock(plotMutex);
+	if (canvas.isStroking())
+	{
+		canvas.strokeTo(eventX, eventY);
+		canvas.endStroke();
+		drawUpdate = true;
+	}
+	pthread_mutex_unlock(plotMutex);
+}
+
+void RUDrawComponent::onMouseMotion(GPanel* cPanel, int eventX, int eventY)
+{
+	pthread_mutex_lock(plotMutex);
+	if (canvas.isStroking())
+	{
+		// the button may have been released outside the component
+		if (SDL_GetMouseState(NULL, NULL) & SDL_BUTTON_LMASK)
+			canvas.strokeTo(eventX, eventY);
+		else
+			canvas.endStroke();
+
+		drawUpdate = true;
+	}
+	pthread_mutex_unlock(plotMutex);
+}
+
+void RUDrawComponent::releaseTextures()
+{
+	canvas.release();
+
+	RUGraph::releaseTextures();
+}
+
 std::string RUDrawComponent::getType() const
 {
 	return "RUDrawComponent";
@@ -17,6 +17,7 @@
 #ifndef _RUDRAWCOMP
 #define _RUDRAWCOMP
 
+#include "DrawCanvas.h"
 #include "RUGraph.h"
 #include <SDL2/SDL.h>
 #include <map>
@@ -40,9 +41,14 @@ private:
 
 	std::vector<Circle*> circles;
 
+	// freehand strokes
+	DrawCanvas canvas;
+
 protected:
 	// events
 	virtual void onMouseDown(GPanel*, int, int);
+	virtual void onMouseUp(GPanel*, int, int);
+	virtual void onMouseMotion(GPanel*, int, int);
 
 public:
 	static const int MODE_CIRCLES = 0;
@@ -62,8 +68,11 @@ public:
 
 	// render
 	virtual void updateBackground(SDL_Renderer*);
+	virtual void releaseTextures();
 	virtual std::string getType() const;
 	void clear(bool = false);
+	bool undo();
+	bool redo();
 
 	// Circle functions
 	void addCircle(const Point2*, double);
@@ -18,13 +18,16 @@
 #include "../../../include/Backend/Database/GList.h"
 #include "../../../include/Backend/Database/gtable.h"
 #include "../../../include/Backend/Database/gtype.h"
+#include "../../GFXUtilities/Bitset.h"
 #include "../../GFXUtilities/point2.h"
+#include "../../GItems/GPanel.h"
 #include "../Text/RULabel.h"
+#include "GraphCandle.h"
 #include "GraphLine.h"
 #include "GraphScatter.h"
 #include "Graphable.h"
 
-RUGraph::RUGraph(int newWidth, int newHeight, int newQuadrants)
+RUGraph::RUGraph(int newWidth, int newHeight, int newQuadrants) : overlayLayer(false)
 {
 	width = newWidth;
 	height = newHeight;
@@ -46,6 +49,23 @@ RUGraph::RUGraph(int newWidth, int newHeight, int newQuadrants)
 	axisWidth = DEFAULT_AXIS_WIDTH;
 	gridEnabled = false;
 	gridLineWidth = DEFAULT_GRIDLINE_WIDTH;
+	gridColor = getBorderColor();
+	windowSize = DEFAULT_WINDOW_SIZE;
+	niceRanges = false;
+	rangeHysteresis = 0.0f;
+	viewStart = 0.0;
+	viewEnd = 1.0;
+	panning = false;
+	panX = 0;
+	hoverEnabled = true;
+	hovering = false;
+	hoverPoint.x = 0;
+	hoverPoint.y = 0;
+	brushMode = false;
+	brushing = false;
+	brushStart.x = brushStart.y = 0;
+	brushEnd.x = brushEnd.y = 0;
+	SelectionChangedListener = 0;
 
 	// plotter mutex
 	plotMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
@@ -60,6 +80,16 @@ RUGraph::RUGraph(int newWidth, int newHeight, int newQuadrants)
 	titleLabel->setText("");
 	titleLabel->setVisible(false);
 	addSubItem(titleLabel);
+
+	// hover readout
+	hoverLabel = new RULabel();
+	hoverLabel->setWidth(250);
+	hoverLabel->setHeight(30);
+	hoverLabel->setMarginX(4);
+	hoverLabel->setMarginY(4);
+	hoverLabel->setText("");
+	hoverLabel->setVisible(false);
+	addSubItem(hoverLabel);
 }
 
 RUGraph::~RUGraph()
@@ -73,8 +103,20 @@ RUGraph::~RUGraph()
 	gridEnabled = false;
 	gridLineWidth = 0;
 	quadrants = QUADRANTS_ONE;
+	windowSize = 0;
+	niceRanges = false;
+	rangeHysteresis = 0.0f;
+	viewStart = 0.0;
+	viewEnd = 1.0;
+	panning = false;
+	hoverEnabled = false;
+	hovering = false;
+	brushMode = false;
+	brushing = false;
+	SelectionChangedListener = 0;
 
 	clear();
+	freeRetired(true);
 
 	// plotter mutex
 	pthread_mutex_destroy(plotMutex);
@@ -116,6 +158,21 @@ int RUGraph::getQuadrants() const
 	return quadrants;
 }
 
+unsigned int RUGraph::getWindowSize() const
+{
+	return windowSize;
+}
+
+bool RUGraph::getNiceRanges() const
+{
+	return niceRanges;
+}
+
+float RUGraph::getRangeHysteresis() const
+{
+	return rangeHysteresis;
+}
+
 float RUGraph::getQuadrantOffsetX() const
 {
 	// quadrant offset
@@ -140,33 +197,253 @@ float RUGraph::getQuadrantOffsetY() const
 	return quadrantOffsetY;
 }
 
+/*!
+ * @brief get the view start
+ * @return the fraction of the x axis at the left edge of the graph
+ */
+double RUGraph::getViewStart() const
+{
+	return viewStart;
+}
+
+/*!
+ * @brief get the view end
+ * @return the fraction of the x axis at the right edge of the graph
+ */
+double RUGraph::getViewEnd() const
+{
+	return viewEnd;
+}
+
+bool RUGraph::getHoverEnabled() const
+{
+	return hoverEnabled;
+}
+
+bool RUGraph::getBrushMode() const
+{
+	return brushMode;
+}
+
+/*!
+ * @brief get the selection
+ * @param label the scatter series
+ * @return one bit per point of the series, set for the brushed points
+ */
+Bitset RUGraph::getSelection(const std::string& label)
+{
+	Bitset selection;
+
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it = lines.find(label);
+	if (it != lines.end())
+	{
+		GraphScatter* cScatter = dynamic_cast<GraphScatter*>(it->second);
+		if (cScatter)
+			selection = cScatter->getSelection();
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	return selection;
+}
+
+/*!
+ * @brief get the selected indices
+ * @param label the scatter series
+ * @return the indices of the brushed points in ascending order
+ */
+std::vector<unsigned int> RUGraph::getSelectedIndices(const std::string& label)
+{
+	std::vector<unsigned int> indices;
+
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it = lines.find(label);
+	if (it != lines.end())
+	{
+		GraphScatter* cScatter = dynamic_cast<GraphScatter*>(it->second);
+		if (cScatter)
+			indices = cScatter->getSelectedIndices();
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	return indices;
+}
+
 void RUGraph::setGraphSize(int newGraphSize)
 {
 	graphSize = newGraphSize;
+	gridLayer.invalidate();
+
+	// nice ranges snap to the grid, so the series redraw on the new one
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		if (it->second)
+			it->second->refreshAxisRanges();
+	}
+	pthread_mutex_unlock(plotMutex);
+
 	drawUpdate = true;
 }
 
 void RUGraph::setAxisWidth(int newAxisWidth)
 {
 	axisWidth = newAxisWidth;
+	gridLayer.invalidate();
 	drawUpdate = true;
 }
 
 void RUGraph::setGridEnabled(bool newGridEnabled)
 {
 	gridEnabled = newGridEnabled;
+	gridLayer.invalidate();
 	drawUpdate = true;
 }
 
 void RUGraph::setGridLineWidth(int newGridLineWidth)
 {
 	gridLineWidth = newGridLineWidth;
+	gridLayer.invalidate();
 	drawUpdate = true;
 }
 
 void RUGraph::setQuadrants(int newQuadrants)
 {
 	quadrants = newQuadrants;
+	invalidateLayers();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief set the window size
+ * @details the number of points kept by series created through appendPoints
+ * @param newWindowSize the number of points, 0 keeps every point
+ */
+void RUGraph::setWindowSize(unsigned int newWindowSize)
+{
+	windowSize = newWindowSize;
+}
+
+void RUGraph::setWindowSize(const std::string& label, unsigned int newWindowSize)
+{
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it = lines.find(label);
+	if ((it != lines.end()) && (it->second))
+		it->second->setWindowSize(newWindowSize);
+	pthread_mutex_unlock(plotMutex);
+
+	drawUpdate = true;
+}
+
+void RUGraph::setNiceRanges(bool newNiceRanges)
+{
+	niceRanges = newNiceRanges;
+
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		if (it->second)
+			it->second->setNiceRanges(niceRanges);
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	drawUpdate = true;
+}
+
+void RUGraph::setRangeHysteresis(float newRangeHysteresis)
+{
+	rangeHysteresis = newRangeHysteresis;
+
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		if (it->second)
+			it->second->setRangeHysteresis(rangeHysteresis);
+	}
+	pthread_mutex_unlock(plotMutex);
+}
+
+/*!
+ * @brief set the view
+ * @details shows part of the x axis. The view keeps its width when it is pushed past either end.
+ * @param newViewStart the fraction of the x axis at the left edge, 0 is the first point
+ * @param newViewEnd the fraction of the x axis at the right edge, 1 is the last point
+ */
+void RUGraph::setView(double newViewStart, double newViewEnd)
+{
+	double span = newViewEnd - newViewStart;
+	if (span > 1.0)
+		span = 1.0;
+	else if (span < 1.0 / MAX_ZOOM)
+		span = 1.0 / MAX_ZOOM;
+
+	if (newViewStart < 0.0)
+		newViewStart = 0.0;
+	else if (newViewStart + span > 1.0)
+		newViewStart = 1.0 - span;
+
+	if ((newViewStart == viewStart) && (newViewStart + span == viewEnd))
+		return;
+
+	viewStart = newViewStart;
+	viewEnd = newViewStart + span;
+	clearHover();
+	invalidateLayers();
+}
+
+void RUGraph::resetView()
+{
+	setView(0.0, 1.0);
+}
+
+/*!
+ * @brief set hover enabled
+ * @details snaps a crosshair and a readout to the point nearest the mouse
+ * @param newHoverEnabled true to follow the mouse
+ */
+void RUGraph::setHoverEnabled(bool newHoverEnabled)
+{
+	hoverEnabled = newHoverEnabled;
+	if (!hoverEnabled)
+		clearHover();
+}
+
+/*!
+ * @brief set brush mode
+ * @details dragging selects the scatter points inside a rectangle instead of panning
+ * @param newBrushMode true to brush
+ */
+void RUGraph::setBrushMode(bool newBrushMode)
+{
+	brushMode = newBrushMode;
+	panning = false;
+	if (brushing)
+	{
+		brushing = false;
+		invalidateOverlay();
+	}
+}
+
+void RUGraph::setSelectionChangedListener(void (GPanel::*f)(void))
+{
+	SelectionChangedListener = f;
+}
+
+void RUGraph::clearSelection()
+{
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		GraphScatter* cScatter = dynamic_cast<GraphScatter*>(it->second);
+		if (cScatter)
+			cScatter->clearSelection();
+	}
+	pthread_mutex_unlock(plotMutex);
+
 	drawUpdate = true;
 }
 
@@ -182,7 +459,59 @@ void RUGraph::setTitleLabel(std::string newLabel)
 	titleLabel->setVisible(true);
 }
 
+/*!
+ * @brief update the background
+ * @details composites the cached layers: the grid, one data layer per series, then the overlay.
+ * Only the layers that were invalidated are rasterized again.
+ * @param renderer the renderer
+ */
 void RUGraph::updateBackground(SDL_Renderer* renderer)
+{
+	// static layer, the axes follow the border color
+	SDL_Color borderColor = getBorderColor();
+	if ((borderColor.r != gridColor.r) || (borderColor.g != gridColor.g) ||
+		(borderColor.b != gridColor.b) || (borderColor.a != gridColor.a))
+		gridLayer.invalidate();
+
+	if (gridLayer.needsUpdate(width, height))
+	{
+		if (gridLayer.begin(renderer, width, height))
+		{
+			gridColor = borderColor;
+			updateGridLayer(renderer);
+			gridLayer.end(renderer);
+		}
+	}
+	gridLayer.draw(renderer);
+
+	// data layers, the plot mutex is only held to snapshot the series list
+	pthread_mutex_lock(plotMutex);
+	freeRetired();
+	drawList.clear();
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		if (it->second)
+			drawList.push_back(it->second);
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	for (unsigned int i = 0; i < drawList.size(); ++i)
+		drawList[i]->updateBackground(renderer);
+
+	// overlay layer
+	if (overlayLayer.needsUpdate(width, height))
+	{
+		if (overlayLayer.begin(renderer, width, height))
+		{
+			updateOverlay(renderer);
+			overlayLayer.end(renderer);
+		}
+	}
+	overlayLayer.draw(renderer);
+}
+
+void RUGraph::updateGridLayer(SDL_Renderer* renderer)
 {
 	// draw the axes
 	if (axisWidth > 0)
@@ -297,37 +626,282 @@ void RUGraph::updateBackground(SDL_Renderer* renderer)
 			SDL_RenderFillRect(renderer, &tickYRect);
 		}
 	}
+}
+
+/*!
+ * @brief update the overlay
+ * @details draws transient marks like a crosshair above the data. Subclasses override it and
+ * call invalidateOverlay when the marks move.
+ * @param renderer the renderer
+ */
+void RUGraph::updateOverlay(SDL_Renderer* renderer)
+{
+	SDL_Color borderColor = getBorderColor();
+	SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
+	// brush
+	if (brushing)
+	{
+		SDL_Rect brushRect;
+		brushRect.x = (brushStart.x < brushEnd.x) ? brushStart.x : brushEnd.x;
+		brushRect.y = (brushStart.y < brushEnd.y) ? brushStart.y : brushEnd.y;
+		brushRect.w = abs(brushEnd.x - brushStart.x) + 1;
+		brushRect.h = abs(brushEnd.y - brushStart.y) + 1;
+		SDL_RenderDrawRect(renderer, &brushRect);
+	}
+
+	if (!hovering)
+		return;
+
+	// crosshair
+	SDL_RenderDrawLine(renderer, hoverPoint.x, 0, hoverPoint.x, height);
+	SDL_RenderDrawLine(renderer, 0, hoverPoint.y, width, hoverPoint.y);
+
+	// marker
+	SDL_Rect marker;
+	marker.x = hoverPoint.x - (HOVER_MARKER_SIZE / 2);
+	marker.y = hoverPoint.y - (HOVER_MARKER_SIZE / 2);
+	marker.w = HOVER_MARKER_SIZE;
+	marker.h = HOVER_MARKER_SIZE;
+	SDL_RenderFillRect(renderer, &marker);
+}
+
+/*!
+ * @brief update the hover
+ * @details asks every series for its point nearest the mouse and snaps the crosshair to the
+ * closest. Each series answers from its own index, so nothing is scanned and the data layers are
+ * left alone.
+ * @param mouseX the x position in graph coordinates
+ * @param mouseY the y position in graph coordinates
+ */
+void RUGraph::updateHover(int mouseX, int mouseY)
+{
+	bool found = false;
+	float bestDistance = 0.0f;
+	SDL_Point bestPoint;
+	Point2 bestValue;
+	std::string bestLabel;
 
-	// draw the lines
 	pthread_mutex_lock(plotMutex);
 	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		if (!it->second)
+			continue;
+
+		SDL_Point cPoint;
+		Point2 cValue;
+		float cDistance;
+		if (!it->second->getNearestPoint(mouseX, mouseY, cValue, cPoint, cDistance))
+			continue;
+
+		if ((!found) || (cDistance < bestDistance))
+		{
+			found = true;
+			bestDistance = cDistance;
+			bestPoint = cPoint;
+			bestValue = cValue;
+			bestLabel = it->first;
+		}
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	if (!found)
+	{
+		clearHover();
+		return;
+	}
+
+	if ((hovering) && (bestPoint.x == hoverPoint.x) && (bestPoint.y == hoverPoint.y))
+		return;
+
+	hovering = true;
+	hoverPoint = bestPoint;
+	hoverLabel->setText(bestLabel + ": (" + shmea::GType::doubleTOstring(bestValue.getX()) + ", " +
+						shmea::GType::doubleTOstring(bestValue.getY()) + ")");
+	hoverLabel->setVisible(true);
+	invalidateOverlay();
+}
+
+void RUGraph::clearHover()
+{
+	if (!hovering)
+		return;
+
+	hovering = false;
+	hoverLabel->setVisible(false);
+	invalidateOverlay();
+}
+
+void RUGraph::invalidateOverlay()
+{
+	overlayLayer.invalidate();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief invalidate the layers
+ * @details marks the grid and every data layer for a redraw, for changes that move the axes
+ */
+void RUGraph::invalidateLayers()
+{
+	gridLayer.invalidate();
+	overlayLayer.invalidate();
 
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
 	for (it = lines.begin(); it != lines.end(); ++it)
 	{
-		Graphable* g = it->second;
-		if (g)
-			g->updateBackground(renderer);
+		if (it->second)
+			it->second->invalidate();
 	}
 	pthread_mutex_unlock(plotMutex);
+
+	drawUpdate = true;
 }
 
-void RUGraph::setPoints(const std::string& label, const std::vector<Point2*>& graphPoints,
-						int lineType, SDL_Color lineColor)
+Graphable* RUGraph::newGraphable(int lineType, SDL_Color lineColor)
 {
-	Graphable* newPlotter;
+	Graphable* newPlotter = NULL;
 	if (lineType == Graphable::LINE)
 		newPlotter = new GraphLine(this, lineColor);
 	else if (lineType == Graphable::SCATTER)
 		newPlotter = new GraphScatter(this, lineColor);
+	else if (lineType == Graphable::CANDLE)
+		newPlotter = new GraphCandle(this, lineColor);
+	else
+		return NULL;
+
+	newPlotter->setNiceRanges(niceRanges);
+	newPlotter->setRangeHysteresis(rangeHysteresis);
+	return newPlotter;
+}
+
+std::string RUGraph::getGraphableType(int lineType)
+{
+	if (lineType == Graphable::LINE)
+		return "GraphLine";
+	else if (lineType == Graphable::SCATTER)
+		return "GraphScatter";
+	else if (lineType == Graphable::CANDLE)
+		return "GraphCandle";
+
+	return "";
+}
+
+/*!
+ * @brief get a graphable
+ * @details finds the series for a label, creating it or replacing it when its type differs. The
+ * caller must hold plotMutex. A replaced series is retired and freed by the renderer. The color
+ * of an existing series is published for the renderer to apply.
+ * @param label the series label
+ * @param lineType the Graphable type
+ * @param lineColor the series color
+ * @return the series, or NULL for an unknown type
+ */
+Graphable* RUGraph::getGraphable(const std::string& label, int lineType, SDL_Color lineColor)
+{
+	std::map<std::string, Graphable*>::iterator it = lines.find(label);
+	if ((it != lines.end()) && (it->second))
+	{
+		if (it->second->getType() == getGraphableType(lineType))
+		{
+			it->second->publishColor(lineColor);
+			return it->second;
+		}
+	}
+
+	Graphable* newPlotter = newGraphable(lineType, lineColor);
+	if (!newPlotter)
+		return NULL;
+
+	if (it != lines.end())
+	{
+		if (it->second)
+			retired.push_back(it->second);
+		it->second = newPlotter;
+	}
 	else
-		return;
-	newPlotter->setPoints(graphPoints);
-	// add the graph comp to the graph
-	pthread_mutex_lock(plotMutex);
-	if (newPlotter)
 		lines[label] = newPlotter;
+
+	return newPlotter;
+}
+
+/*!
+ * @brief free the retired series
+ * @details the renderer may still be drawing a series that a producer replaced, so retired series
+ * are freed at the start of the next frame, once no producer is publishing to them. The caller
+ * must hold plotMutex.
+ * @param all free them all, when no producer can be left
+ */
+void RUGraph::freeRetired(bool all)
+{
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < retired.size(); ++i)
+	{
+		if ((!all) && (retired[i]->hasProducers()))
+			retired[kept++] = retired[i];
+		else
+			delete retired[i];
+	}
+	retired.resize(kept);
+}
+
+/*!
+ * @brief acquire a graphable
+ * @details looks up the series under plotMutex and holds it for a producer, so the data can be
+ * published without the lock. Call removeProducer on it when done.
+ * @param label the series label
+ * @param lineType the Graphable type
+ * @param lineColor the series color
+ * @return the series, or NULL for an unknown type
+ */
+Graphable* RUGraph::acquireGraphable(const std::string& label, int lineType, SDL_Color lineColor)
+{
+	pthread_mutex_lock(plotMutex);
+	Graphable* plotter = getGraphable(label, lineType, lineColor);
+	if (plotter)
+		plotter->addProducer();
 	pthread_mutex_unlock(plotMutex);
 
+	return plotter;
+}
+
+void RUGraph::setPoints(const std::string& label, const std::vector<Point2*>& graphPoints,
+						int lineType, SDL_Color lineColor)
+{
+	Graphable* plotter = acquireGraphable(label, lineType, lineColor);
+	if (plotter)
+	{
+		plotter->setPoints(graphPoints);
+		plotter->removeProducer();
+	}
+
+	// trigger the draw update
+	drawUpdate = true;
+}
+
+/*!
+ * @brief set points
+ * @details publishes a snapshot of the series. The renderer picks up the newest snapshot at the
+ * start of its next frame, so the producer never waits on a draw.
+ * @param label the series label
+ * @param xValues the x column
+ * @param yValues the y column
+ * @param count the number of points in each column
+ * @param lineType the Graphable type
+ * @param lineColor the series color
+ */
+void RUGraph::setPoints(const std::string& label, const float* xValues, const float* yValues,
+						unsigned int count, int lineType, SDL_Color lineColor)
+{
+	Graphable* plotter = acquireGraphable(label, lineType, lineColor);
+	if (plotter)
+	{
+		plotter->setPoints(xValues, yValues, count);
+		plotter->removeProducer();
+	}
+
 	// trigger the draw update
 	drawUpdate = true;
 }
@@ -335,22 +909,64 @@ void RUGraph::setPoints(const std::string& label, const std::vector<Point2*>& gr
 void RUGraph::setLine(const std::string& label, const shmea::GList& graphPoints, int lineType,
 					  SDL_Color lineColor)
 {
-	Graphable* newPlotter;
-	if (lineType == Graphable::LINE)
-		newPlotter = new GraphLine(this, lineColor);
-	else if (lineType == Graphable::SCATTER)
-		newPlotter = new GraphScatter(this, lineColor);
-	else
-		return;
-	newPlotter->setLine(graphPoints);
-	// add the graph comp to the graph
+	Graphable* plotter = acquireGraphable(label, lineType, lineColor);
+	if (plotter)
+	{
+		plotter->setLine(graphPoints);
+		plotter->removeProducer();
+	}
+
+	// trigger the draw update
+	drawUpdate = true;
+}
+
+/*!
+ * @brief append points
+ * @details streams n points onto the end of a series. The series is created on the first call and
+ * keeps the newest getWindowSize() points, so a live feed never grows without bound. The points
+ * are queued for the renderer; producers on the same series take turns.
+ * @param label the series label
+ * @param xValues the x column
+ * @param yValues the y column
+ * @param count the number of points in each column
+ * @param lineType the Graphable type used when the series is created
+ * @param lineColor the color used when the series is created
+ * @return the number of points queued
+ */
+unsigned int RUGraph::appendPoints(const std::string& label, const float* xValues,
+								   const float* yValues, unsigned int count, int lineType,
+								   SDL_Color lineColor)
+{
+	if (count == 0)
+		return 0;
+
 	pthread_mutex_lock(plotMutex);
-	if (newPlotter)
-		lines[label] = newPlotter;
+	Graphable* plotter = NULL;
+	std::map<std::string, Graphable*>::iterator it = lines.find(label);
+	if (it != lines.end())
+		plotter = it->second;
+
+	if (!plotter)
+	{
+		plotter = newGraphable(lineType, lineColor);
+		if (!plotter)
+		{
+			pthread_mutex_unlock(plotMutex);
+			return 0;
+		}
+
+		plotter->setWindowSize(windowSize);
+		lines[label] = plotter;
+	}
+	plotter->addProducer();
 	pthread_mutex_unlock(plotMutex);
 
+	unsigned int queued = plotter->appendPoints(xValues, yValues, count);
+	plotter->removeProducer();
+
 	// trigger the draw update
 	drawUpdate = true;
+	return queued;
 }
 
 void RUGraph::addScatterPoints(const shmea::GTable& graphPoints)
@@ -373,17 +989,66 @@ void RUGraph::addScatterPoints(const shmea::GTable& graphPoints)
 		shmea::GList xPoints = graphPoints.getCol(i);
 		shmea::GList yPoints = graphPoints.getCol(i + 1);
 
-		// build the line
-		std::vector<Point2*> points;
-		for (unsigned int p = 0; p < xPoints.size(); ++p)
-			points.push_back(new Point2(xPoints.getDouble(p), yPoints.getDouble(p)));
+		// build the columns
+		unsigned int pointCount = xPoints.size();
+		if (yPoints.size() < pointCount)
+			pointCount = yPoints.size();
+		if (pointCount == 0)
+			continue;
+
+		std::vector<float> xValues(pointCount);
+		std::vector<float> yValues(pointCount);
+		for (unsigned int p = 0; p < pointCount; ++p)
+		{
+			xValues[p] = xPoints.getFloat(p);
+			yValues[p] = yPoints.getFloat(p);
+		}
 
 		// set the line
 		int pairIndex = i / 2;
-		setPoints(shmea::GType::intTOstring(pairIndex), points, 1, colorOpts[pairIndex % 5]);
+		setPoints(shmea::GType::intTOstring(pairIndex), &xValues[0], &yValues[0], pointCount,
+				  Graphable::SCATTER, colorOpts[pairIndex % 5]);
 	}
 }
 
+/*!
+ * @brief set candles
+ * @details plots open/high/low/close bars from the first four columns of a table
+ * @param label the series label
+ * @param candles the table
+ * @param candleColor the candle color
+ */
+void RUGraph::setCandles(const std::string& label, const shmea::GTable& candles,
+						 SDL_Color candleColor)
+{
+	Graphable* series = acquireGraphable(label, Graphable::CANDLE, candleColor);
+	if (!series)
+		return;
+
+	GraphCandle* plotter = dynamic_cast<GraphCandle*>(series);
+	if (plotter)
+		plotter->setCandles(candles);
+	series->removeProducer();
+
+	// trigger the draw update
+	drawUpdate = true;
+}
+
+void RUGraph::appendCandle(const std::string& label, float candleOpen, float candleHigh,
+						   float candleLow, float candleClose, SDL_Color candleColor)
+{
+	Graphable* series = acquireGraphable(label, Graphable::CANDLE, candleColor);
+	if (!series)
+		return;
+
+	GraphCandle* plotter = dynamic_cast<GraphCandle*>(series);
+	if (plotter)
+		plotter->appendCandle(candleOpen, candleHigh, candleLow, candleClose);
+	series->removeProducer();
+
+	drawUpdate = true;
+}
+
 void RUGraph::buildDotMatrix()
 {
 	// Lets create the dot grid
@@ -413,15 +1078,193 @@ void RUGraph::clear(bool toggleDraw)
 	pthread_mutex_lock(plotMutex);
 	std::map<std::string, Graphable*>::iterator it;
 
+	// the renderer may be drawing them
 	for (it = lines.begin(); it != lines.end(); ++it)
-		delete it->second;
+	{
+		if (it->second)
+			retired.push_back(it->second);
+	}
 	lines.clear();
 	pthread_mutex_unlock(plotMutex);
 
+	clearHover();
+
 	if (toggleDraw)
 		drawUpdate = true;
 }
 
+/*!
+ * @brief mouse down
+ * @details starts dragging the view, or the brush in brush mode
+ */
+void RUGraph::onMouseDown(GPanel* cPanel, int eventX, int eventY)
+{
+	if (brushMode)
+	{
+		brushing = true;
+		brushStart.x = brushEnd.x = eventX;
+		brushStart.y = brushEnd.y = eventY;
+		invalidateOverlay();
+		return;
+	}
+
+	panning = true;
+	panX = eventX;
+}
+
+/*!
+ * @brief mouse up
+ * @details ends a drag. A brush selects the scatter points inside it.
+ */
+void RUGraph::onMouseUp(GPanel* cPanel, int eventX, int eventY)
+{
+	panning = false;
+	if (!brushing)
+		return;
+
+	brushing = false;
+	brushEnd.x = eventX;
+	brushEnd.y = eventY;
+
+	pthread_mutex_lock(plotMutex);
+	std::map<std::string, Graphable*>::iterator it;
+	for (it = lines.begin(); it != lines.end(); ++it)
+	{
+		GraphScatter* cScatter = dynamic_cast<GraphScatter*>(it->second);
+		if (cScatter)
+			cScatter->selectRect(brushStart.x, brushStart.y, brushEnd.x, brushEnd.y);
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	invalidateOverlay();
+
+	if ((cPanel) && (SelectionChangedListener != 0))
+		(cPanel->*SelectionChangedListener)();
+}
+
+/*!
+ * @brief unhover
+ * @details the mouse left the graph, motion events stop so the crosshair is cleared here
+ */
+void RUGraph::unhover()
+{
+	clearHover();
+}
+
+/*!
+ * @brief mouse motion
+ * @details pans the view with the drag, one pixel of drag moves the data one pixel, or stretches
+ * the brush. Otherwise follows the mouse with the hover crosshair.
+ */
+void RUGraph::onMouseMotion(GPanel* cPanel, int eventX, int eventY)
+{
+	if ((!panning) && (!brushing))
+	{
+		if (hoverEnabled)
+			updateHover(eventX, eventY);
+		return;
+	}
+
+	// the button may have been released outside the graph
+	if (!(SDL_GetMouseState(NULL, NULL) & SDL_BUTTON_LMASK))
+	{
+		panning = false;
+		if (brushing)
+		{
+			brushing = false;
+			invalidateOverlay();
+		}
+		return;
+	}
+
+	if (brushing)
+	{
+		brushEnd.x = eventX;
+		brushEnd.y = eventY;
+		invalidateOverlay();
+		return;
+	}
+
+	if ((eventX == panX) || (getWidth() <= 0))
+		return;
+
+	double shift = ((double)(panX - eventX) / getWidth()) * (viewEnd - viewStart);
+	panX = eventX;
+	setView(viewStart + shift, viewEnd + shift);
+}
+
+/*!
+ * @brief mouse wheel
+ * @details zooms the view in or out around the x position of the mouse
+ */
+void RUGraph::onMouseWheel(GPanel* cPanel, int eventX, int eventY, int scrollType)
+{
+	if (getWidth() <= 0)
+		return;
+
+	double scale = 1.0;
+	if (scrollType == SCROLL_UP)
+		scale = (100.0 - ZOOM_PERCENT) / 100.0;
+	else if (scrollType == SCROLL_DOWN)
+		scale = 100.0 / (100.0 - ZOOM_PERCENT);
+	else
+		return;
+
+	// keep the point under the mouse in place
+	double anchor = (double)eventX / getWidth();
+	if (anchor < 0.0)
+		anchor = 0.0;
+	else if (anchor > 1.0)
+		anchor = 1.0;
+
+	double span = viewEnd - viewStart;
+	double anchorValue = viewStart + (anchor * span);
+	span *= scale;
+	setView(anchorValue - (anchor * span), anchorValue + ((1.0 - anchor) * span));
+}
+
+/*!
+ * @brief release textures
+ * @details frees the layers of the graph and its series, they are rasterized again when shown
+ */
+void RUGraph::releaseTextures()
+{
+	gridLayer.release();
+	overlayLayer.release();
+
+	// the plot mutex is only held to snapshot the series list
+	pthread_mutex_lock(plotMutex);
+	drawList.clear();
+	std::map<std::string, Graphable*>::iterator it = lines.begin();
+	for (; it != lines.end(); ++it)
+	{
+		if (it->second)
+			drawList.push_back(it->second);
+	}
+	pthread_mutex_unlock(plotMutex);
+
+	for (unsigned int i = 0; i < drawList.size(); ++i)
+		drawList[i]->releaseTextures();
+
+	RUComponent::releaseTextures();
+}
+
+/*!
+ * @brief get the clip rect
+ * @details includes the title, it sits above the graph
+ */
+SDL_Rect RUGraph::getClipRect() const
+{
+	SDL_Rect clip = getLocationRect();
+	if ((titleLabel) && (titleLabel->isVisible()))
+	{
+		SDL_Rect titleRect = titleLabel->getLocationRect();
+		SDL_UnionRect(&clip, &titleRect, &clip);
+	}
+
+	return clip;
+}
+
 std::string RUGraph::getType() const
 {
 	return "RUGraph";
@@ -19,6 +19,7 @@
 
 #include "../../GItems/RUColors.h"
 #include "../../GItems/RUComponent.h"
+#include "GraphLayer.h"
 #include <SDL2/SDL.h>
 #include <map>
 #include <pthread.h>
@@ -27,6 +28,7 @@
 #include <string>
 #include <vector>
 
+class Bitset;
 class Graphable;
 class Point2;
 class RULabel;
@@ -46,6 +48,46 @@ private:
 	bool gridEnabled;
 	int gridLineWidth;
 	int quadrants;
+	unsigned int windowSize;
+	bool niceRanges;
+	float rangeHysteresis;
+
+	// visible fraction of the x axis
+	double viewStart;
+	double viewEnd;
+	bool panning;
+	int panX;
+
+	// nearest point under the mouse, drawn in the overlay
+	bool hoverEnabled;
+	bool hovering;
+	SDL_Point hoverPoint;
+	RULabel* hoverLabel;
+
+	// rectangle brush over the scatter series
+	bool brushMode;
+	bool brushing;
+	SDL_Point brushStart;
+	SDL_Point brushEnd;
+	void (GPanel::*SelectionChangedListener)(void);
+
+	// cached layers, composited in updateBackground
+	GraphLayer gridLayer;
+	GraphLayer overlayLayer;
+	SDL_Color gridColor;
+
+	// series replaced or cleared since the last frame
+	std::vector<Graphable*> retired;
+	std::vector<Graphable*> drawList;
+
+	Graphable* newGraphable(int, SDL_Color);
+	Graphable* getGraphable(const std::string&, int, SDL_Color);
+	Graphable* acquireGraphable(const std::string&, int, SDL_Color);
+	void freeRetired(bool = false);
+	static std::string getGraphableType(int);
+	void updateGridLayer(SDL_Renderer*);
+	void updateHover(int, int);
+	void clearHover();
 
 protected:
 	// std::vector<GraphLine*> lines;
@@ -53,8 +95,17 @@ protected:
 	pthread_mutex_t* plotMutex;
 	RULabel* titleLabel;
 
+	// events
+	virtual void onMouseDown(GPanel*, int, int);
+	virtual void onMouseUp(GPanel*, int, int);
+	virtual void onMouseMotion(GPanel*, int, int);
+	virtual void onMouseWheel(GPanel*, int, int, int);
+
 	// render
 	virtual void updateBackground(SDL_Renderer*);
+	virtual void updateOverlay(SDL_Renderer*);
+	void invalidateOverlay();
+	void invalidateLayers();
 
 public:
 	static const unsigned int DEFAULT_NUM_ZONES = 10;
@@ -62,6 +113,10 @@ public:
 	static const unsigned int DEFAULT_GRAPH_SIZE = 1;
 	static const unsigned int DEFAULT_AXIS_WIDTH = 3;
 	static const unsigned int DEFAULT_GRIDLINE_WIDTH = 1;
+	static const unsigned int DEFAULT_WINDOW_SIZE = 4096;
+	static const unsigned int MAX_ZOOM = 1000000;
+	static const unsigned int ZOOM_PERCENT = 20;
+	static const int HOVER_MARKER_SIZE = 7;
 
 	static const int QUADRANTS_ONE = 0;
 	static const int QUADRANTS_FOUR = 1;
@@ -78,8 +133,17 @@ public:
 	bool getGridEnabled() const;
 	int getGridLineWidth() const;
 	int getQuadrants() const;
+	unsigned int getWindowSize() const;
+	bool getNiceRanges() const;
+	float getRangeHysteresis() const;
 	float getQuadrantOffsetX() const;
 	float getQuadrantOffsetY() const;
+	double getViewStart() const;
+	double getViewEnd() const;
+	bool getHoverEnabled() const;
+	bool getBrushMode() const;
+	Bitset getSelection(const std::string&);
+	std::vector<unsigned int> getSelectedIndices(const std::string&);
 
 	// sets
 	void setGraphSize(int);
@@ -87,14 +151,35 @@ public:
 	void setGridEnabled(bool);
 	void setGridLineWidth(int);
 	void setQuadrants(int);
+	void setWindowSize(unsigned int);
+	void setWindowSize(const std::string&, unsigned int);
+	void setNiceRanges(bool);
+	void setRangeHysteresis(float);
 	void setTitleLabel(std::string);
+	void setView(double, double);
+	void resetView();
+	void setHoverEnabled(bool);
+	void setBrushMode(bool);
+	void setSelectionChangedListener(void (GPanel::*)(void));
+	void clearSelection();
 
+	virtual void releaseTextures();
+	virtual SDL_Rect getClipRect() const;
+	virtual void unhover();
 	virtual std::string getType() const;
 	void setPoints(const std::string&, const std::vector<Point2*>&, int = 0,
 				   SDL_Color = RUColors::DEFAULT_COLOR_LINE);
+	void setPoints(const std::string&, const float*, const float*, unsigned int, int = 0,
+				   SDL_Color = RUColors::DEFAULT_COLOR_LINE);
 	void setLine(const std::string&, const shmea::GList&, int = 0,
 				 SDL_Color = RUColors::DEFAULT_COLOR_LINE);
+	unsigned int appendPoints(const std::string&, const float*, const float*, unsigned int,
+							  int = 0, SDL_Color = RUColors::DEFAULT_COLOR_LINE);
 	void addScatterPoints(const shmea::GTable&);
+	void setCandles(const std::string&, const shmea::GTable&,
+					SDL_Color = RUColors::DEFAULT_COLOR_CANDLE);
+	void appendCandle(const std::string&, float, float, float, float,
+					  SDL_Color = RUColors::DEFAULT_COLOR_CANDLE);
 	void buildDotMatrix();
 	void clear(bool = false);
 };
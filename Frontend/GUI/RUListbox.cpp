@@ -18,6 +18,22 @@
 #include "../GItems/RUColors.h"
 #include "RUScrollbar.h"
 #include "Text/RULabel.h"
+#include "Text/RUTextbox.h"
+
+/*!
+ * @brief set a label color
+ * @details only redraws the label when the color changes
+ */
+static void setLabelColor(RULabel* cLabel, SDL_Color newColor)
+{
+	SDL_Color oldColor = cLabel->getBGColor();
+	if ((oldColor.r == newColor.r) && (oldColor.g == newColor.g) && (oldColor.b == newColor.b) &&
+		(oldColor.a == newColor.a))
+		return;
+
+	cLabel->setBGColor(newColor);
+	cLabel->requireDrawUpdate();
+}
 
 RUListbox::RUListbox()
 {
@@ -25,6 +41,11 @@ RUListbox::RUListbox()
 	multiSelectEnabled = true;
 	optionsShown = 0;
 	itemHovered = (unsigned int)-1;
+	labelWidth = 0;
+	labelHeight = 0;
+	searchBox = NULL;
+	searchIndexDirty = true;
+	searchHeight = 0;
 
 	// add the scrollbar
 	scrollbar = new RUScrollbar();
@@ -39,12 +60,18 @@ RUListbox::~RUListbox()
 	toggleBorder(true);
 	optionsShown = 0;
 	itemsSelected.clear();
+	options.clear();
 
 	// delete the scrollbar
 	if (scrollbar)
 		delete scrollbar;
 	scrollbar = NULL;
 
+	// delete the search box
+	if (searchBox)
+		delete searchBox;
+	searchBox = NULL;
+
 	// delete the labels
 	for (unsigned int i = 0; i < items.size(); ++i)
 	{
@@ -65,13 +92,91 @@ unsigned int RUListbox::getOptionsShown() const
 }
 
 const std::vector<unsigned int> RUListbox::getItemsSelected() const
+{
+	std::vector<unsigned int> selectedIndices;
+	unsigned int index = itemsSelected.findNext(0);
+	for (; index != Bitset::NPOS; index = itemsSelected.findNext(index + 1))
+		selectedIndices.push_back(index);
+
+	return selectedIndices;
+}
+
+/*!
+ * @brief get the selection
+ * @return one bit per option, set when the option is selected
+ */
+const Bitset& RUListbox::getSelection() const
 {
 	return itemsSelected;
 }
 
+bool RUListbox::isSelected(unsigned int index) const
+{
+	return (index < itemsSelected.size()) && (itemsSelected.test(index));
+}
+
+/*!
+ * @brief get the first selection
+ * @return the lowest selected option, or (unsigned int)-1 if none are selected
+ */
+unsigned int RUListbox::getFirstSelected() const
+{
+	return itemsSelected.findNext(0);
+}
+
+std::string RUListbox::getOption(unsigned int index) const
+{
+	if (index >= options.size())
+		return "";
+
+	return options[index];
+}
+
 unsigned int RUListbox::size() const
 {
-	return items.size();
+	return options.size();
+}
+
+bool RUListbox::getSearchEnabled() const
+{
+	return (searchBox != NULL);
+}
+
+std::string RUListbox::getSearchText() const
+{
+	return searchText;
+}
+
+/*!
+ * @brief get the search height
+ * @return the height of the search box above the options, 0 without one
+ */
+int RUListbox::getSearchHeight() const
+{
+	return searchHeight;
+}
+
+/*!
+ * @brief get the view size
+ * @return the number of options shown, after the search
+ */
+unsigned int RUListbox::getViewSize() const
+{
+	if (!searchText.empty())
+		return searchIndex.size();
+	return options.size();
+}
+
+/*!
+ * @brief get a view option
+ * @param index the position in the view
+ * @return the option shown there
+ */
+unsigned int RUListbox::getViewOption(unsigned int index) const
+{
+	if (!searchText.empty())
+		return searchIndex.get(index);
+	return index;
 }
 
 void RUListbox::setWidth(int newWidth)
@@ -81,16 +186,6 @@ void RUListbox::setWidth(int newWidth)
 
 	width = newWidth;
 
-	// update the labels
-	int newLabelWidth = getWidth();
-	if (items.size() + 1 > optionsShown)
-	{
-		//
-		newLabelWidth -= scrollbar->getWidth();
-		for (unsigned int i = 0; i < items.size(); ++i)
-			items[i]->setWidth(newLabelWidth);
-	}
-
 	// Some basic scrollbar width behavior
 	if (getWidth() <= DEFAULT_SCROLLBAR_WIDTH * 2)
 	{
@@ -103,6 +198,9 @@ void RUListbox::setWidth(int newWidth)
 		scrollbar->setMarginX(getWidth() - scrollbar->getWidth());
 	}
 
+	// update the labels
+	layoutLabels();
+
 	drawUpdate = true;
 }
 
@@ -113,26 +211,8 @@ void RUListbox::setHeight(int newHeight)
 
 	height = newHeight;
 
-	// update the labels
-	for (unsigned int i = 0; i < items.size(); ++i)
-	{
-		if (optionsShown > 0)
-		{
-			int labelHeight = getHeight() / optionsShown;
-			items[i]->setMarginY(i * labelHeight);
-			items[i]->setHeight(labelHeight);
-			items[i]->setFontSize(labelHeight / 2);
-		}
-		else
-		{
-			items[i]->setMarginY(0);
-			items[i]->setHeight(0);
-			items[i]->setFontSize(0);
-		}
-	}
-
-	// update the scrollbar
-	scrollbar->setHeight(getHeight());
+	// update the labels and the scrollbar
+	layoutLabels();
 
 	drawUpdate = true;
 }
@@ -149,97 +229,72 @@ void RUListbox::setOptionsShown(unsigned int newOptionsShown)
 	// update the scrollbar
 	scrollbar->setOptionsShown(optionsShown);
 
-	drawUpdate = true;
+	updateLabels();
 }
 
+/*!
+ * @brief add an option
+ * @details stores the option text, only the labels in view are touched
+ * @param newItemText the option text
+ */
 void RUListbox::addOption(std::string newItemText)
 {
-	int newLabelWidth = getWidth();
-	if (items.size() + 1 > optionsShown)
-	{
-		//
-		newLabelWidth -= scrollbar->getWidth();
-		for (unsigned int i = 0; i < items.size(); ++i)
-			items[i]->setWidth(newLabelWidth);
-	}
+	options.push_back(newItemText);
+	itemsSelected.resize(options.size());
+	searchIndexDirty = true;
 
-	// create the new item label
-	RULabel* newLabel = new RULabel(newItemText);
-	newLabel->setMarginX(0);
-	newLabel->setWidth(newLabelWidth);
-	newLabel->setCursor(SDL_SYSTEM_CURSOR_HAND);
-	newLabel->toggleBorder(true);
-	if (optionsShown > 0)
-	{
-		unsigned int cIndex = scrollbar->getValue();
-		int labelHeight = getHeight() / optionsShown;
-		newLabel->setMarginY(items.size() * labelHeight);
-		newLabel->setHeight(labelHeight);
-		newLabel->setFontSize(labelHeight / 2);
-		newLabel->setVisible((items.size() >= cIndex) && (items.size() - cIndex < optionsShown));
-	}
-	else
-	{
-		newLabel->setMarginY(0);
-		newLabel->setHeight(0);
-		newLabel->setFontSize(0);
-		newLabel->setVisible(false);
-	}
+	updateSearch();
+	updateScrollbar();
+	updateLabels();
+}
 
-	// add the label
-	items.push_back(newLabel);
-	addSubItem(newLabel);
-	scrollbar->setMaxValue(items.size());
-	if (items.size() > optionsShown)
-		scrollbar->setVisible(true);
+/*!
+ * @brief add options
+ * @details appends many options at once, laying out the labels in view a single time
+ * @param newOptions the option texts
+ */
+void RUListbox::addOptions(const std::vector<std::string>& newOptions)
+{
+	if (newOptions.empty())
+		return;
 
-	// single select
-	if ((!multiSelectEnabled) && (itemsSelected.size() == 1))
-		itemsSelected.push_back(0);
+	options.insert(options.end(), newOptions.begin(), newOptions.end());
+	itemsSelected.resize(options.size());
+	searchIndexDirty = true;
 
-	drawUpdate = true;
+	updateSearch();
+	updateScrollbar();
+	updateLabels();
 }
 
 void RUListbox::addSelection(unsigned int newIndex)
 {
-	if ((newIndex != (unsigned int)-1) && (newIndex >= size()))
+	if (newIndex >= size())
 		return;
 
 	// single select
-	if ((!multiSelectEnabled) && (itemsSelected.size() > 0))
+	if (!multiSelectEnabled)
 		clearSelections();
 
-	bool itemFound = false;
-	int insertIndex = itemsSelected.size();
-	for (unsigned int i = 0; i < itemsSelected.size(); ++i)
-	{
-		if (itemsSelected[i] == newIndex)
-		{
-			itemsSelected.erase(itemsSelected.begin() + i);
-			itemFound = true;
-			// unhighlight label
-			items[itemsSelected[i]]->setBGColor(RUColors::DEFAULT_COLOR_BACKGROUND);
-			break;
-		}
-		else if (itemsSelected[i] > newIndex)
-		{
-			insertIndex = i;
-			break;
-		}
-	}
+	toggleSelection(newIndex);
+}
 
-	// insert the item
-	if (!itemFound)
-	{
-		itemsSelected.insert(itemsSelected.begin() + insertIndex, newIndex);
-		// highlight label
-		items[itemsSelected[insertIndex]]->setBGColor(RUColors::DEFAULT_BUTTON_HOVER_BLUE);
-	}
+/*!
+ * @brief toggle a selection
+ * @param index the option to select or unselect
+ */
+void RUListbox::toggleSelection(unsigned int index)
+{
+	if (index >= itemsSelected.size())
+		return;
+
+	itemsSelected.flip(index);
+	drawUpdate = true;
 }
 
 void RUListbox::clearSelections()
 {
-	itemsSelected.clear();
+	itemsSelected.setAll(false);
 	drawUpdate = true;
 }
 
@@ -254,109 +309,245 @@ void RUListbox::clearSelections()
 }*/
 
 /*!
- * @brief remove all items
- * @details clear all labels from the list
+ * @brief update the scrollbar
+ * @details sizes the scrollbar to the options in view
  */
-void RUListbox::clearOptions()
+void RUListbox::updateScrollbar()
 {
-	// Trim the rows
-	subitems.clear();
-	for (unsigned int i = 0; i < items.size(); ++i)
+	unsigned int viewSize = getViewSize();
+	scrollbar->setMaxValue(viewSize);
+	scrollbar->setVisible(viewSize > optionsShown);
+}
+
+/*!
+ * @brief enable the search
+ * @details shows a search box above the options. Typing in it only shows the options starting
+ * with the text, ignoring case.
+ * @param enable whether to show the search box
+ */
+void RUListbox::setSearchEnabled(bool enable)
+{
+	if (enable == (searchBox != NULL))
+		return;
+
+	if (enable)
 	{
-		RULabel* cLabel = items[i];
-		if (!cLabel)
-			continue;
+		searchBox = new RUTextbox();
+		searchBox->toggleBorder(true);
+		searchBox->setMarginX(0);
+		searchBox->setMarginY(0);
+	}
+	else
+	{
+		searchBox->setVisible(false);
+		delete searchBox;
+		searchBox = NULL;
+	}
+
+	// lay out again
+	labelHeight = -1;
+	updateSearch();
+	updateScrollbar();
+	updateLabels();
+}
+
+/*!
+ * @brief set the search text
+ * @param newText the text the options shown must start with
+ */
+void RUListbox::setSearchText(const std::string& newText)
+{
+	if (!searchBox)
+		return;
+
+	searchBox->setText(newText);
+	updateSearch();
+}
+
+/*!
+ * @brief update the search
+ * @details narrows the options in view when the search text changes. The index is only built
+ * on the first search after the options change, and is kept for every search after it.
+ */
+void RUListbox::updateSearch()
+{
+	std::string newText = searchBox ? searchBox->getText() : "";
+	if ((newText == searchText) && ((newText.empty()) || (!searchIndexDirty)))
+		return;
 
-		cLabel->setVisible(false);
-		delete cLabel;
+	if ((!newText.empty()) && (searchIndexDirty))
+	{
+		searchIndex.build(options);
+		searchIndexDirty = false;
 	}
-	items.clear();
-	addSubItem(scrollbar);
+
+	searchText = newText;
+	if (!searchText.empty())
+		searchIndex.setPrefix(searchText);
+
+	// back to the top of the matches
+	itemHovered = (unsigned int)-1;
+	scrollbar->setValue(0);
+	updateScrollbar();
+	updateLabels();
+}
+
+/*!
+ * @brief remove all items
+ * @details clear all options from the list, keeping the labels for reuse
+ */
+void RUListbox::clearOptions()
+{
+	options.clear();
+	itemsSelected.clear();
+	itemHovered = (unsigned int)-1;
+	searchIndex.clear();
+	searchIndexDirty = true;
 
 	// reset the scrollbar position
 	scrollbar->setValue(0);
 	scrollbar->setMaxValue(0);
+	scrollbar->setVisible(false);
 	updateLabels();
-	itemsSelected.clear();
-	clearItems(1);
-	drawUpdate = true;
 }
 
 void RUListbox::updateBackground(SDL_Renderer* renderer)
 {
 	if (optionsShown > 0)
 	{
+		unsigned int cIndex = scrollbar->getValue();
+		const unsigned int viewSize = getViewSize();
 		for (unsigned int i = 0; i < items.size(); ++i)
 		{
-			// Check if selected item
-			bool isSelected = false;
-			for (unsigned int j = 0; j < itemsSelected.size(); ++j)
-			{
-				// Don't do anything to keep existing highlight
-				if (i == itemsSelected[j])
-				{
-					isSelected = true;
-					break;
-				}
-			}
-
-			if (!isSelected)
-			{
-				// Add/Remove highlight if not selected
-				if (i == itemHovered)
-					items[itemHovered]->setBGColor(RUColors::DEFAULT_BUTTON_BLUE);
-				else
-					items[i]->setBGColor(RUColors::DEFAULT_COLOR_BACKGROUND);
-			}
+			if (cIndex + i >= viewSize)
+				break;
+
+			unsigned int option = getViewOption(cIndex + i);
+			if (isSelected(option))
+				setLabelColor(items[i], RUColors::DEFAULT_BUTTON_HOVER_BLUE);
+			else if (option == itemHovered)
+				setLabelColor(items[i], RUColors::DEFAULT_BUTTON_BLUE);
+			else
+				setLabelColor(items[i], RUColors::DEFAULT_COLOR_BACKGROUND);
 		}
 	}
 }
 
+/*!
+ * @brief lay out the labels
+ * @details keeps one label per option shown and sizes them to the listbox, only when the pool or
+ * the label size changes
+ */
+void RUListbox::layoutLabels()
+{
+	// one label per option shown
+	bool poolChanged = (items.size() != optionsShown);
+	while (items.size() > optionsShown)
+	{
+		delete items.back();
+		items.pop_back();
+	}
+
+	while (items.size() < optionsShown)
+	{
+		RULabel* newLabel = new RULabel();
+		newLabel->setMarginX(0);
+		newLabel->setCursor(SDL_SYSTEM_CURSOR_HAND);
+		newLabel->toggleBorder(true);
+		items.push_back(newLabel);
+	}
+
+	const unsigned int itemCount = items.size() + ((searchBox) ? 2 : 1);
+	if ((poolChanged) || (subitems.size() != itemCount))
+	{
+		subitems.clear();
+		addSubItem(scrollbar);
+		if (searchBox)
+			addSubItem(searchBox);
+		for (unsigned int i = 0; i < items.size(); ++i)
+			addSubItem(items[i]);
+	}
+
+	// the search box takes a row above the options
+	unsigned int rowSlots = optionsShown;
+	if ((searchBox) && (optionsShown > 0))
+		++rowSlots;
+
+	int newLabelWidth = getWidth();
+	if (getViewSize() > optionsShown)
+		newLabelWidth -= scrollbar->getWidth();
+	int newLabelHeight = (rowSlots > 0) ? (getHeight() / rowSlots) : 0;
+	if ((!poolChanged) && (newLabelWidth == labelWidth) && (newLabelHeight == labelHeight))
+		return;
+
+	labelWidth = newLabelWidth;
+	labelHeight = newLabelHeight;
+	searchHeight = (searchBox) ? labelHeight : 0;
+	if (searchBox)
+	{
+		searchBox->setWidth(getWidth());
+		searchBox->setHeight(searchHeight);
+		searchBox->setFontSize(searchHeight / 2);
+	}
+
+	scrollbar->setMarginY(searchHeight);
+	scrollbar->setHeight(getHeight() - searchHeight);
+
+	for (unsigned int i = 0; i < items.size(); ++i)
+	{
+		items[i]->setMarginY(searchHeight + (i * labelHeight));
+		items[i]->setWidth(labelWidth);
+		items[i]->setHeight(labelHeight);
+		items[i]->setFontSize(labelHeight / 2);
+	}
+
+	std::pair<int, int> offset(0, 0);
+	calculateSubItemPositions(offset);
+}
+
 /*!
  * @brief update visible labels
- * @details update the label visibility based on the scrollbar position
+ * @details binds the labels to the options at the scrollbar position
  */
 void RUListbox::updateLabels()
 {
+	layoutLabels();
+
 	unsigned int cIndex = scrollbar->getValue();
+	const unsigned int viewSize = getViewSize();
 	for (unsigned int i = 0; i < items.size(); ++i)
 	{
-		if (optionsShown > 0)
+		if (cIndex + i < viewSize)
 		{
-			int labelHeight = getHeight() / optionsShown;
-			items[i]->setMarginY((i - cIndex) * labelHeight);
-			items[i]->setHeight(labelHeight);
-			items[i]->setFontSize(labelHeight / 2);
-			items[i]->setVisible((i >= cIndex) && (i - cIndex < optionsShown));
+			items[i]->setText(options[getViewOption(cIndex + i)]);
+			items[i]->setVisible(true);
 		}
 		else
-		{
-			items[i]->setMarginY(0);
-			items[i]->setHeight(0);
-			items[i]->setFontSize(0);
 			items[i]->setVisible(false);
-		}
 	}
 
-	std::pair<int, int> offset(0, 0);
-	calculateSubItemPositions(offset);
-
 	drawUpdate = true;
 }
 
 void RUListbox::onMouseMotion(GPanel* cPanel, int eventX, int eventY)
 {
 	// selecting listbox items
-	if (optionsShown > 0)
+	if ((optionsShown > 0) && (labelHeight > 0))
 	{
-		int scrollbarVal = scrollbar->getValue();
-		int labelHeight = getHeight() / optionsShown;
-		itemHovered = eventY - (eventY % labelHeight);
-		itemHovered /= labelHeight;
-		itemHovered += scrollbarVal;
-	}
+		unsigned int newHovered = (unsigned int)-1;
+		if (eventY >= searchHeight)
+		{
+			unsigned int viewIndex = ((eventY - searchHeight) / labelHeight) + scrollbar->getValue();
+			if (viewIndex < getViewSize())
+				newHovered = getViewOption(viewIndex);
+		}
 
-	updateLabels();
+		if (newHovered == itemHovered)
+			return;
+
+		itemHovered = newHovered;
+		drawUpdate = true;
+	}
 }
 
 void RUListbox::onMouseDown(GPanel* cPanel, int eventX, int eventY)
@@ -371,50 +562,33 @@ void RUListbox::onMouseDown(GPanel* cPanel, int eventX, int eventY)
 	}
 
 	// selecting listbox items
-	if (optionsShown > 0)
+	if ((optionsShown > 0) && (labelHeight > 0))
 	{
-		int scrollbarVal = scrollbar->getValue();
-		int labelHeight = getHeight() / optionsShown;
-		unsigned int itemClicked = eventY - (eventY % labelHeight);
-		itemClicked /= labelHeight;
-		itemClicked += scrollbarVal;
-		if (itemClicked >= items.size())
+		// search box click
+		if (eventY < searchHeight)
 			return;
 
-		// single select
-		if ((!multiSelectEnabled) && (itemsSelected.size() > 0))
-			clearSelections();
-
-		bool itemFound = false;
-		unsigned int insertIndex = itemsSelected.size();
-		for (unsigned int i = 0; i < itemsSelected.size(); ++i)
-		{
-			if (itemsSelected[i] == itemClicked)
-			{
-				itemsSelected.erase(itemsSelected.begin() + i);
-				itemFound = true;
-				// unhighlight label here
-				items[itemClicked]->setBGColor(RUColors::DEFAULT_COLOR_BACKGROUND);
-				break;
-			}
-			else if (itemsSelected[i] > itemClicked)
-			{
-				insertIndex = i;
-				break;
-			}
-		}
+		unsigned int viewIndex = ((eventY - searchHeight) / labelHeight) + scrollbar->getValue();
+		if (viewIndex >= getViewSize())
+			return;
 
-		// insert the item
-		if (!itemFound)
-		{
-			itemsSelected.insert(itemsSelected.begin() + insertIndex, itemClicked);
-			// highlight label here
-			items[itemClicked]->setBGColor(RUColors::DEFAULT_BUTTON_HOVER_BLUE);
-		}
+		addSelection(getViewOption(viewIndex));
 	}
 
 	updateLabels();
 }
+/*!
+ * @brief process subitem events
+ * @details passes the event on, then narrows the options if it was typed into the search box
+ */
+void RUListbox::processSubItemEvents(EventTracker* eventsStatus, GPanel* parentPanel,
+									 SDL_Event event, int mouseX, int mouseY)
+{
+	RUComponent::processSubItemEvents(eventsStatus, parentPanel, event, mouseX, mouseY);
+
+	if ((searchBox) && (event.type == SDL_KEYDOWN))
+		updateSearch();
+}
 
 void RUListbox::onMouseWheel(GPanel* cPanel, int eventX, int eventY, int scrollType)
 {
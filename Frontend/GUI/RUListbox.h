@@ -17,6 +17,8 @@
 #ifndef _RULISTBOX
 #define _RULISTBOX
 
+#include "../GFXUtilities/Bitset.h"
+#include "../GFXUtilities/PrefixIndex.h"
 #include "../GItems/RUComponent.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,6 +27,7 @@
 
 class RULabel;
 class RUScrollbar;
+class RUTextbox;
 
 class RUListbox : public RUComponent
 {
@@ -33,11 +36,28 @@ class RUListbox : public RUComponent
 protected:
 	bool multiSelectEnabled;
 	unsigned int optionsShown;
-	std::vector<RULabel*> items;
+	std::vector<std::string> options;
+	std::vector<RULabel*> items; // pool, one per option shown
 	unsigned int itemHovered;
-	std::vector<unsigned int> itemsSelected;
+	Bitset itemsSelected;
 	RUScrollbar* scrollbar;
 	bool hoverDraw;
+	int labelWidth;
+	int labelHeight;
+
+	// type-ahead, the options shown are the ones starting with the search text
+	RUTextbox* searchBox;
+	PrefixIndex searchIndex;
+	bool searchIndexDirty;
+	std::string searchText;
+	int searchHeight;
+
+	void layoutLabels();
+	void toggleSelection(unsigned int);
+	unsigned int getViewSize() const;
+	unsigned int getViewOption(unsigned int) const;
+	void updateSearch();
+	void updateScrollbar();
 
 	// events
 	virtual void onMouseMotion(GPanel*, int, int);
@@ -55,7 +75,14 @@ public:
 	bool getMultiSelect() const;
 	unsigned int getOptionsShown() const;
 	const std::vector<unsigned int> getItemsSelected() const;
+	const Bitset& getSelection() const;
+	bool isSelected(unsigned int) const;
+	unsigned int getFirstSelected() const;
+	std::string getOption(unsigned int) const;
 	unsigned int size() const;
+	bool getSearchEnabled() const;
+	std::string getSearchText() const;
+	int getSearchHeight() const;
 
 	// sets
 	void setWidth(int);
@@ -63,11 +90,17 @@ public:
 	void setMultiSelect(bool);
 	void setOptionsShown(unsigned int);
 	void addOption(std::string);
+	void addOptions(const std::vector<std::string>&);
 	void addSelection(unsigned int);
 	void clearSelections();
 	void clearOptions();
+	void setSearchEnabled(bool);
+	void setSearchText(const std::string&);
 	// void clear();
 
+	// events
+	virtual void processSubItemEvents(EventTracker*, GPanel*, SDL_Event, int, int);
+
 	// render
 	virtual void updateBackground(SDL_Renderer*);
 	void updateLabels();
@@ -220,7 +220,7 @@ void RUMsgBox::msgButtonOKClicked()
 {
 	// close it
 	setVisible(false);
-	panel->removeItem(this->getID());
+	panel->removeOverlay(this);
 
 	// printf("\nOK CLICKED\n");
 }
@@ -231,7 +231,7 @@ void RUMsgBox::confirmButtonYESClicked()
 	setVisible(false);
 	confirmButtonYES->setVisible(false);
 	confirmButtonNO->setVisible(false);
-	panel->removeItem(this->getID());
+	panel->removeOverlay(this);
 
 	confirmButtonClicked = 0;
 
@@ -244,7 +244,7 @@ void RUMsgBox::confirmButtonNOClicked()
 	setVisible(false);
 	confirmButtonYES->setVisible(false);
 	confirmButtonNO->setVisible(false);
-	panel->removeItem(this->getID());
+	panel->removeOverlay(this);
 
 	confirmButtonClicked = 1;
 
@@ -257,7 +257,7 @@ void RUMsgBox::inputButtonSUBMITClicked()
 	setVisible(false);
 	inputText->setVisible(false);
 	inputButtonSubmit->setVisible(false);
-	panel->removeItem(this->getID());
+	panel->removeOverlay(this);
 
 	inputSubmitText = inputText->getText();
 
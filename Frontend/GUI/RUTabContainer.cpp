@@ -18,15 +18,30 @@
 #include "../GItems/RUColors.h"
 #include "Text/RULabel.h"
 
+std::vector<RUTabContainer*> RUTabContainer::containers;
+
 RUTabContainer::RUTabContainer()
 {
 	orientation = HORIZONTAL_TABS;
 	optionsShown = 0;
 	itemHovered = (unsigned int)-1;
+	tabSelected = -1;
+	prevTabSelected = -1;
+	releaseDelay = DEFAULT_RELEASE_DELAY;
+	containers.push_back(this);
 }
 
 RUTabContainer::~RUTabContainer()
 {
+	for (unsigned int i = 0; i < containers.size(); ++i)
+	{
+		if (containers[i] == this)
+		{
+			containers.erase(containers.begin() + i);
+			break;
+		}
+	}
+
 	// delete the labels
 	for (unsigned int i = 0; i < items.size(); ++i)
 	{
@@ -42,6 +57,8 @@ RUTabContainer::~RUTabContainer()
 		}
 	}
 
+	tabStates.clear();
+
 	optionsShown = 0;
 	prevTabSelected = -1;
 	tabSelected = -1;
@@ -62,6 +79,34 @@ unsigned int RUTabContainer::size() const
 	return items.size();
 }
 
+/*!
+ * @brief is a tab built
+ * @param index the tab
+ * @return false while a tab with a factory has not been shown yet
+ */
+bool RUTabContainer::isTabBuilt(unsigned int index) const
+{
+	if (index >= tabStates.size())
+		return false;
+
+	return tabStates[index].built;
+}
+
+Uint32 RUTabContainer::getReleaseDelay() const
+{
+	return releaseDelay;
+}
+
+/*!
+ * @brief set the release delay
+ * @details hidden tabs free the textures of their items after this long, NEVER_RELEASE keeps them
+ * @param newReleaseDelay the delay in milliseconds
+ */
+void RUTabContainer::setReleaseDelay(Uint32 newReleaseDelay)
+{
+	releaseDelay = newReleaseDelay;
+}
+
 void RUTabContainer::setWidth(int newWidth)
 {
 	width = newWidth;
@@ -150,6 +195,15 @@ void RUTabContainer::addTab(std::string newItemText)
 	items.push_back(newItem);
 	addSubItem(newLabel);
 
+	TabState newState;
+	newState.factoryPanel = NULL;
+	newState.factory = 0;
+	newState.built = true;
+	newState.hidden = false;
+	newState.released = false;
+	newState.hiddenAt = 0;
+	tabStates.push_back(newState);
+
 	// Auto select first added tab
 	if (items.size() == 1)
 	{
@@ -161,6 +215,78 @@ void RUTabContainer::addTab(std::string newItemText)
 	drawUpdate = true;
 }
 
+/*!
+ * @brief add a lazy tab
+ * @details adds a tab whose items are built by the factory the first time the tab is selected.
+ * The factory should create the items and add them with addItemToTab.
+ * @param newItemText the tab name
+ * @param factoryPanel the panel the factory belongs to
+ * @param factory the panel function that builds the tab
+ */
+void RUTabContainer::addTab(std::string newItemText, GPanel* factoryPanel,
+							void (GPanel::*factory)(const std::string&))
+{
+	addTab(newItemText);
+
+	TabState& newState = tabStates.back();
+	newState.factoryPanel = factoryPanel;
+	newState.factory = factory;
+	newState.built = ((!factoryPanel) || (!factory));
+
+	// the first tab is selected right away
+	if (tabSelected == items.size() - 1)
+		activateTab(tabSelected);
+}
+
+/*!
+ * @brief activate a tab
+ * @details builds the tab on its first activation, and has released items drawn again
+ * @param index the tab
+ */
+void RUTabContainer::activateTab(unsigned int index)
+{
+	if (index >= tabStates.size())
+		return;
+
+	TabState& cState = tabStates[index];
+	if (!cState.built)
+	{
+		cState.built = true;
+		(cState.factoryPanel->*cState.factory)(items[index].first->getText());
+	}
+
+	if (cState.released)
+	{
+		for (unsigned int j = 0; j < items[index].second.size(); ++j)
+			items[index].second[j]->requireDrawUpdate();
+	}
+
+	cState.hidden = false;
+	cState.released = false;
+}
+
+/*!
+ * @brief release hidden tabs
+ * @details frees the textures of the items of tabs hidden for longer than the release delay
+ */
+void RUTabContainer::releaseHiddenTabs()
+{
+	if (releaseDelay == NEVER_RELEASE)
+		return;
+
+	Uint32 now = SDL_GetTicks();
+	for (unsigned int i = 0; i < tabStates.size(); ++i)
+	{
+		TabState& cState = tabStates[i];
+		if ((!cState.hidden) || (cState.released) || (now - cState.hiddenAt < releaseDelay))
+			continue;
+
+		for (unsigned int j = 0; j < items[i].second.size(); ++j)
+			items[i].second[j]->releaseTextures();
+		cState.released = true;
+	}
+}
+
 void RUTabContainer::addItemToTab(std::string tabText, GItem* tabItem)
 {
 
@@ -194,6 +320,7 @@ void RUTabContainer::clearOptions()
 		delete cLabel;
 	}
 	items.clear();
+	tabStates.clear();
 
 	updateLabels();
 	prevTabSelected = tabSelected;
@@ -212,6 +339,7 @@ void RUTabContainer::setSelectedTab(unsigned int newIndex)
 			prevTabSelected = tabSelected;
 			tabSelected = newIndex;
 			items[tabSelected].first->setBGColor(RUColors::DEFAULT_BUTTON_HOVER_BLUE);
+			activateTab(tabSelected);
 		}
 		else
 		{
@@ -246,6 +374,7 @@ void RUTabContainer::setSelectedTab(std::string tabName)
 				prevTabSelected = tabSelected;
 				tabSelected = i;
 				items[tabSelected].first->setBGColor(RUColors::DEFAULT_BUTTON_HOVER_BLUE);
+				activateTab(tabSelected);
 			}
 		}
 
@@ -269,6 +398,17 @@ void RUTabContainer::setOptionChangedListener(void (GPanel::*f)(int))
 	OptionChangedListener = f;
 }
 
+/*!
+ * @brief release all hidden tabs
+ * @details called once a frame by the frame loop rather than from the draw, which skips the
+ * containers inside a flattened layer
+ */
+void RUTabContainer::releaseAllHiddenTabs()
+{
+	for (unsigned int i = 0; i < containers.size(); ++i)
+		containers[i]->releaseHiddenTabs();
+}
+
 void RUTabContainer::updateBackground(SDL_Renderer* renderer)
 {
 	if (optionsShown > 0)
@@ -297,6 +437,13 @@ void RUTabContainer::updateBackground(SDL_Renderer* renderer)
 					// Hide unselected tabs' GItems
 					for (int j = 0; j < tabContainer.size(); ++j)
 						tabContainer[j]->setVisible(false);
+
+					// start the release timer
+					if ((i < tabStates.size()) && (!tabStates[i].hidden))
+					{
+						tabStates[i].hidden = true;
+						tabStates[i].hiddenAt = SDL_GetTicks();
+					}
 				}
 			}
 			else
@@ -398,6 +545,7 @@ void RUTabContainer::onMouseDown(GPanel* cPanel, int eventX, int eventY)
 			tabSelected = itemClicked;
 			// highlight new label selection here
 			items[tabSelected].first->setBGColor(RUColors::DEFAULT_BUTTON_HOVER_BLUE);
+			activateTab(tabSelected);
 		}
 	}
 
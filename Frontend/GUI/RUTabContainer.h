@@ -42,6 +42,29 @@ protected:
 	typedef std::pair<RULabel*, std::vector<GItem*> > RUTab;
 	std::vector<RUTab> items;
 
+	// builds the items of a tab, called with the tab name
+	typedef void (GPanel::*TabFactory)(const std::string&);
+
+	class TabState
+	{
+	public:
+		GPanel* factoryPanel;
+		TabFactory factory;
+		bool built;
+		bool hidden;
+		bool released;
+		Uint32 hiddenAt;
+	};
+
+	std::vector<TabState> tabStates; // one per tab
+	Uint32 releaseDelay;
+
+	// every live container, ticked by the frame loop
+	static std::vector<RUTabContainer*> containers;
+
+	void activateTab(unsigned int);
+	void releaseHiddenTabs();
+
 	bool hoverDraw;
 
 	// events
@@ -51,6 +74,8 @@ protected:
 
 public:
 	static const int DEFAULT_SIDE_WIDTH = 24;
+	static const Uint32 DEFAULT_RELEASE_DELAY = 30000; // ms
+	static const Uint32 NEVER_RELEASE = 0xFFFFFFFF;
 
 	// constructors & destructor
 	RUTabContainer();
@@ -60,12 +85,16 @@ public:
 	unsigned int getOptionsShown() const;
 	unsigned int getTabSelected();
 	unsigned int size() const;
+	bool isTabBuilt(unsigned int) const;
+	Uint32 getReleaseDelay() const;
 
 	// sets
 	void setWidth(int);
 	void setHeight(int);
 	void setOptionsShown(unsigned int);
 	void addTab(std::string);
+	void addTab(std::string, GPanel*, void (GPanel::*)(const std::string&));
+	void setReleaseDelay(Uint32);
 	void addItemToTab(std::string, GItem*);
 	void clearOptions();
 	void setSelectedTab(unsigned int); // int = index
@@ -75,6 +104,7 @@ public:
 	void setOptionChangedListener(void (GPanel::*)(int));
 
 	// render
+	static void releaseAllHiddenTabs();
 	virtual void updateBackground(SDL_Renderer*);
 	void updateLabels();
 	virtual void unhover();
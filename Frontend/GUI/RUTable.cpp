@@ -15,9 +15,11 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RUTable.h"
+#include "../GFXUtilities/Bitset.h"
 #include "../GItems/RUColors.h"
 #include "RUScrollbar.h"
 #include "Text/RULabel.h"
+#include <math.h>
 
 /*!
  * @brief RUTable constructor
@@ -27,6 +29,24 @@ RUTable::RUTable()
 {
 	toggleBorder(true);
 	rowsShown = 0;
+	boundTable = this;
+	firstRow = 0;
+	labelCellWidth = 0;
+	labelCellHeight = 0;
+	bodyTexture = NULL;
+	bodyScratch = NULL;
+	headerTexture = NULL;
+	bodyWidth = 0;
+	bodyHeight = 0;
+	bodyDirty = true;
+	scrollY = 0;
+	drawnScrollY = 0;
+	scrollVelocity = 0.0f;
+	indexed = false;
+	indexedRows = 0;
+	sortCol = -1;
+	sortAscending = true;
+	headerHeight = 0;
 
 	// add the scrollbar
 	scrollbar = new RUScrollbar();
@@ -44,6 +64,21 @@ RUTable::~RUTable()
 {
 	toggleBorder(true);
 	rowsShown = 0;
+	boundTable = NULL;
+
+	// delete the labels
+	resizeLabelPool(0, 0);
+
+	// delete the body
+	if (bodyTexture)
+		SDL_DestroyTexture(bodyTexture);
+	bodyTexture = NULL;
+	if (bodyScratch)
+		SDL_DestroyTexture(bodyScratch);
+	bodyScratch = NULL;
+	if (headerTexture)
+		SDL_DestroyTexture(headerTexture);
+	headerTexture = NULL;
 
 	// delete the scrollbar
 	if (scrollbar)
@@ -62,6 +97,83 @@ unsigned int RUTable::getRowsShown() const
 	return rowsShown;
 }
 
+/*!
+ * @brief get the table
+ * @return the table the cells are read from
+ */
+const shmea::GTable* RUTable::getTable() const
+{
+	return boundTable;
+}
+
+/*!
+ * @brief get the first row
+ * @return the row shown at the top of the component
+ */
+unsigned int RUTable::getFirstRow() const
+{
+	return firstRow;
+}
+
+/*!
+ * @brief get the scroll position
+ * @return the pixel offset of the rows from the top of the table
+ */
+int RUTable::getScrollY() const
+{
+	return scrollY;
+}
+
+/*!
+ * @brief get the row count
+ * @return the number of rows in the view, after the filters
+ */
+unsigned int RUTable::getRowCount() const
+{
+	if (indexed)
+		return rowIndex.size();
+	return boundTable->numberOfRows();
+}
+
+/*!
+ * @brief get a source row
+ * @param row the row in the view
+ * @return the row of the table shown there
+ */
+unsigned int RUTable::getSourceRow(unsigned int row) const
+{
+	if (indexed)
+		return rowIndex.get(row);
+	return row;
+}
+
+/*!
+ * @brief get the sort column
+ * @return the column the view is sorted by, -1 if unsorted
+ */
+int RUTable::getSortCol() const
+{
+	return sortCol;
+}
+
+bool RUTable::isSortAscending() const
+{
+	return sortAscending;
+}
+
+/*!
+ * @brief get a filter
+ * @param col the column
+ * @return the text the column's cells must contain, empty if unfiltered
+ */
+std::string RUTable::getFilter(unsigned int col) const
+{
+	std::map<unsigned int, std::string>::const_iterator it = filters.find(col);
+	if (it == filters.end())
+		return "";
+	return it->second;
+}
+
 /*!
  * @brief RUTable import
  * @details imports an RUTable from a GTable, copying its rows, headers, etc
@@ -70,7 +182,24 @@ unsigned int RUTable::getRowsShown() const
 void RUTable::import(const shmea::GTable& newTable)
 {
 	copy(newTable);
+	boundTable = this;
+
+	rebuildIndex();
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief bind a table
+ * @details shows a table without copying it. Only the visible cells are read, so binding costs
+ * the same for any number of rows. The table must outlive the binding.
+ * @param newTable the table to show, NULL shows this table's own rows
+ */
+void RUTable::bind(const shmea::GTable* newTable)
+{
+	boundTable = newTable ? newTable : this;
 
+	rebuildIndex();
 	updateLabels();
 	drawUpdate = true;
 }
@@ -88,7 +217,32 @@ void RUTable::setRowsShown(unsigned int newRowsShown)
 	// update the scrollbar
 	scrollbar->setOptionsShown(rowsShown);
 
-	refreshLabels();
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief set the scroll position
+ * @details clamps the pixel offset to the rows and moves the scrollbar to the top row
+ * @param newScrollY the pixel offset of the rows from the top of the table
+ */
+void RUTable::setScrollY(int newScrollY)
+{
+	if (labelCellHeight <= 0)
+		return;
+
+	int maxScrollY = (getRowCount() * labelCellHeight) - bodyHeight;
+	if (newScrollY > maxScrollY)
+		newScrollY = maxScrollY;
+	if (newScrollY < 0)
+		newScrollY = 0;
+
+	if (newScrollY == scrollY)
+		return;
+
+	scrollY = newScrollY;
+	firstRow = scrollY / labelCellHeight;
+	scrollbar->setValue(firstRow);
 	drawUpdate = true;
 }
 
@@ -128,164 +282,650 @@ void RUTable::setHeight(int newHeight)
 }
 
 /*!
- * @brief clear
- * @details clears the RUTable of contents
+ * @brief sort by a column
+ * @details orders the view by a column without touching the table. Numeric columns sort by value
+ * and the rest by text. The sort is stable, so ties keep the order of the previous sort.
+ * @param col the column to sort by
+ * @param ascending the order
  */
-void RUTable::clear()
+void RUTable::sortBy(unsigned int col, bool ascending)
 {
-	shmea::GTable::clear();
-	scrollbar->setValue(0);
-	scrollbar->setMaxValue(0);
-	scrollbar->setVisible(false);
+	if (col >= boundTable->numberOfCols())
+		return;
+
+	sortCol = col;
+	sortAscending = ascending;
 
+	// re-sort the current view so ties keep their order, unless the table changed under it
+	if ((indexed) && (indexedRows == boundTable->numberOfRows()))
+		sortIndex();
+	else
+		rebuildIndex();
 	updateLabels();
 	drawUpdate = true;
 }
 
 /*!
- * @brief update visible labels
- * @details update the label visibility based on the scrollbar position
+ * @brief clear the sort
+ * @details shows the rows in table order again, keeping the filters
  */
-void RUTable::updateLabels()
+void RUTable::clearSort()
 {
-	unsigned int cIndex = scrollbar->getValue();
+	if (sortCol < 0)
+		return;
 
-	// Number of visible rows in the new table
-	unsigned int maxRows = cIndex + rowsShown;
-	if (maxRows > numberOfRows())
-		maxRows = numberOfRows();
+	sortCol = -1;
 
-	// Trim the rows
-	subitems.clear();
-	for (unsigned int row = 0; row < textLabels.size(); ++row)
+	rebuildIndex();
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief set a filter
+ * @details only shows the rows whose cell in a column contains the text
+ * @param col the column to filter
+ * @param text the text to look for, empty removes the column's filter
+ */
+void RUTable::setFilter(unsigned int col, const std::string& text)
+{
+	if (text.empty())
+		filters.erase(col);
+	else
+		filters[col] = text;
+
+	rebuildIndex();
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief clear the filters
+ * @details shows every row again, keeping the sort
+ */
+void RUTable::clearFilters()
+{
+	if (filters.empty())
+		return;
+
+	filters.clear();
+
+	rebuildIndex();
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief rebuild the index
+ * @details filters and then sorts the row index over the table, starting from table order. The
+ * table is read a column at a time and never reordered.
+ */
+void RUTable::rebuildIndex()
+{
+	const unsigned int rowCount = boundTable->numberOfRows();
+	const unsigned int colCount = boundTable->numberOfCols();
+	if ((sortCol >= 0) && ((unsigned int)sortCol >= colCount))
+		sortCol = -1;
+
+	indexed = ((sortCol >= 0) || (!filters.empty()));
+	if (!indexed)
 	{
-		int toggleVis = 0;
-		if (row >= numberOfRows())
-			++toggleVis;
+		rowIndex.clear();
+		return;
+	}
 
-		// Trim the cols
-		for (unsigned int col = 0; col < textLabels[row].size(); ++col)
+	rowIndex.reset(rowCount);
+	indexedRows = rowCount;
+
+	// keep the rows that contain every filter
+	if (!filters.empty())
+	{
+		Bitset keep(rowCount);
+		keep.setAll(true);
+
+		std::map<unsigned int, std::string>::const_iterator it = filters.begin();
+		for (; it != filters.end(); ++it)
 		{
-			if ((col >= textLabels[row].size()) || (toggleVis > 0))
-			{
-				RULabel* cLabel = textLabels[row][col];
-				if (!cLabel)
-					continue;
+			if (it->first >= colCount)
+				continue;
 
-				cLabel->setVisible(false);
-				delete cLabel;
+			shmea::GList colList = boundTable->getCol(it->first);
+			for (unsigned int row = 0; (row < rowCount) && (row < colList.size()); ++row)
+			{
+				if ((keep.test(row)) && (colList.getString(row).find(it->second) == std::string::npos))
+					keep.reset(row);
 			}
 		}
+
+		rowIndex.filter(keep);
 	}
-	textLabels.clear();
-	addSubItem(scrollbar);
 
-	// No data
-	if (numberOfCols() == 0)
+	sortIndex();
+}
+
+/*!
+ * @brief sort the index
+ * @details stable sort of the current view by the sort column, so rows that tie keep the order
+ * they had before
+ */
+void RUTable::sortIndex()
+{
+	if (sortCol < 0)
 		return;
 
-	// No rows shown
-	if (!(rowsShown > 0))
+	const unsigned int rowCount = boundTable->numberOfRows();
+
+	// numeric columns sort by value, the rest by text
+	shmea::GList colList = boundTable->getCol(sortCol);
+	const unsigned int keyCount = (colList.size() < rowCount) ? colList.size() : rowCount;
+	bool numeric = true;
+	for (unsigned int row = 0; (row < keyCount) && (numeric); ++row)
+	{
+		int cellType = colList.getType(row);
+		if ((cellType != shmea::GType::NULL_TYPE) &&
+			((cellType < shmea::GType::BOOLEAN_TYPE) || (cellType > shmea::GType::DOUBLE_TYPE)))
+			numeric = false;
+	}
+
+	if (numeric)
+	{
+		std::vector<double> keys(rowCount, NAN);
+		for (unsigned int row = 0; row < keyCount; ++row)
+		{
+			if (colList.getType(row) != shmea::GType::NULL_TYPE)
+				keys[row] = colList.getDouble(row);
+		}
+
+		rowIndex.sort(keys, sortAscending);
+	}
+	else
+	{
+		std::vector<std::string> keys(rowCount);
+		for (unsigned int row = 0; row < keyCount; ++row)
+			keys[row] = colList.getString(row);
+
+		rowIndex.sort(keys, sortAscending);
+	}
+}
+
+/*!
+ * @brief clear
+ * @details clears the RUTable of contents
+ */
+void RUTable::clear()
+{
+	shmea::GTable::clear();
+	boundTable = this;
+	scrollY = 0;
+	firstRow = 0;
+	scrollVelocity = 0.0f;
+	sortCol = -1;
+	filters.clear();
+	rebuildIndex();
+	scrollbar->setValue(0);
+	scrollbar->setMaxValue(0);
+	scrollbar->setVisible(false);
+
+	updateLabels();
+	drawUpdate = true;
+}
+
+/*!
+ * @brief update visible labels
+ * @details sizes the scrollbar and the label pool to the table and the rows shown. The pool only
+ * holds the visible cells, so this costs the same for any number of rows.
+ */
+void RUTable::updateLabels()
+{
+	const unsigned int rowCount = getRowCount();
+	const unsigned int colCount = boundTable->numberOfCols();
+
+	// No data or no rows shown
+	if ((colCount == 0) || (!(rowsShown > 0)))
 	{
 		// clear the scrollbar
 		scrollbar->setValue(0);
 		scrollbar->setMaxValue(0);
 		scrollbar->setVisible(false);
 
+		resizeLabelPool(0, 0);
 		drawUpdate = true;
 		return;
 	}
 
 	// Put the scrollbar back
-	int newMaxValue = numberOfRows() - rowsShown;
+	int newMaxValue = rowCount - rowsShown;
 	if (newMaxValue < 0)
 	{
-		newMaxValue = numberOfRows();
+		newMaxValue = rowCount;
 		scrollbar->setVisible(false);
 	}
 	else
 		scrollbar->setVisible(true);
 	scrollbar->setMaxValue(newMaxValue);
 
-	// update the labels
-	int cellHeight = height / rowsShown;
-	int cellWidth = width / numberOfCols();
-	if (scrollbar->isVisible())
-		cellWidth = (width - scrollbar->getWidth()) / numberOfCols();
-	for (unsigned int row = 0; row < maxRows; ++row)
+	// one label per visible cell, and a row for the partly scrolled one
+	resizeLabelPool(rowsShown + 1, colCount, !boundTable->getHeaders().empty());
+
+	// Refresh the text in the labels
+	labelCellWidth = 0;
+	labelCellHeight = 0;
+	refreshLabels();
+	setScrollY(scrollY);
+}
+
+/*!
+ * @brief resize the label pool
+ * @details keeps the labels that still fit and only creates or deletes the difference
+ * @param poolRows the number of label rows
+ * @param poolCols the number of label columns
+ * @param withHeaders whether to keep a header label per column
+ */
+void RUTable::resizeLabelPool(unsigned int poolRows, unsigned int poolCols, bool withHeaders)
+{
+	// one header label per column
+	const unsigned int headerCount = withHeaders ? poolCols : 0;
+	bool changed = ((textLabels.size() != poolRows) || (headerLabels.size() != headerCount));
+	while (headerLabels.size() > headerCount)
+	{
+		delete headerLabels.back();
+		headerLabels.pop_back();
+	}
+
+	while (headerLabels.size() < headerCount)
+	{
+		RULabel* newItem = new RULabel();
+		newItem->toggleBorder(true);
+		headerLabels.push_back(newItem);
+	}
+
+	for (unsigned int row = 0; row < textLabels.size(); ++row)
+	{
+		std::vector<RULabel*>& labelRow = textLabels[row];
+		unsigned int keepCols = (row < poolRows) ? poolCols : 0;
+		if (labelRow.size() != keepCols)
+			changed = true;
+
+		for (unsigned int col = keepCols; col < labelRow.size(); ++col)
+		{
+			if (!labelRow[col])
+				continue;
+
+			labelRow[col]->setVisible(false);
+			delete labelRow[col];
+		}
+
+		if (labelRow.size() > keepCols)
+			labelRow.resize(keepCols);
+	}
+
+	if (!changed)
+		return;
+
+	textLabels.resize(poolRows);
+	for (unsigned int row = 0; row < poolRows; ++row)
 	{
-		std::vector<RULabel*> newRow;
-		for (unsigned int col = 0; col < numberOfCols(); ++col)
+		for (unsigned int col = textLabels[row].size(); col < poolCols; ++col)
 		{
-			RULabel* newItem = new RULabel(getCell(row, col).getString());
-			newItem->setMarginX(col * cellWidth);
-			newItem->setMarginY(row * cellHeight);
-			newItem->setWidth(cellWidth);
-			newItem->setHeight(cellHeight);
-			newItem->setFontSize(cellHeight / 2);
+			RULabel* newItem = new RULabel();
 			newItem->toggleBorder(true);
-			newRow.push_back(newItem);
-			addSubItem(newItem);
+			textLabels[row].push_back(newItem);
 		}
-		textLabels.push_back(newRow);
 	}
 
-	// Refresh the text in the labels
-	refreshLabels();
+	labelCellWidth = 0;
+	labelCellHeight = 0;
+	bodyDirty = true;
+}
 
-	std::pair<int, int> offset(0, 0);
-	calculateSubItemPositions(offset);
+/*!
+ * @brief lay out the labels
+ * @details sizes the pooled labels to the component, only when the cell size changes
+ */
+void RUTable::layoutLabels()
+{
+	if ((rowsShown == 0) || (textLabels.empty()) || (textLabels[0].empty()))
+		return;
 
-	drawUpdate = true;
+	const unsigned int colCount = textLabels[0].size();
+	bodyWidth = width;
+	if (scrollbar->isVisible())
+		bodyWidth = width - scrollbar->getWidth();
+
+	// the headers take a row above the body
+	unsigned int rowSlots = rowsShown;
+	if (!headerLabels.empty())
+		++rowSlots;
+
+	int cellHeight = height / rowSlots;
+	int cellWidth = bodyWidth / colCount;
+	headerHeight = headerLabels.empty() ? 0 : cellHeight;
+	bodyHeight = height - headerHeight;
+	if ((cellWidth == labelCellWidth) && (cellHeight == labelCellHeight))
+		return;
+
+	// keep the top row in place
+	if (labelCellHeight > 0)
+		scrollY = (scrollY * cellHeight) / labelCellHeight;
+
+	labelCellWidth = cellWidth;
+	labelCellHeight = cellHeight;
+	for (unsigned int row = 0; row < textLabels.size(); ++row)
+	{
+		for (unsigned int col = 0; col < textLabels[row].size(); ++col)
+		{
+			RULabel* cLabel = textLabels[row][col];
+			cLabel->setWidth(cellWidth);
+			cLabel->setHeight(cellHeight);
+			cLabel->setFontSize(cellHeight / 2);
+		}
+	}
+
+	for (unsigned int col = 0; col < headerLabels.size(); ++col)
+	{
+		headerLabels[col]->setWidth(cellWidth);
+		headerLabels[col]->setHeight(cellHeight);
+		headerLabels[col]->setFontSize(cellHeight / 2);
+	}
+
+	bodyDirty = true;
 }
 
+/*!
+ * @brief refresh the labels
+ * @details redraws every visible row on the next frame, for when the cells change in place
+ */
 void RUTable::refreshLabels()
 {
-	if (rowsShown == 0)
+	if (textLabels.empty())
 		return;
 
-	if (numberOfRows() == 0)
+	layoutLabels();
+
+	bodyDirty = true;
+	drawUpdate = true;
+}
+
+/*!
+ * @brief draw the headers
+ * @details draws the column headers above the body, marking the sort column. The headers are kept
+ * in a texture and only drawn again along with the whole body.
+ * @param renderer the renderer to draw with
+ */
+void RUTable::drawHeaders(SDL_Renderer* renderer)
+{
+	if ((headerLabels.empty()) || (headerHeight <= 0) || (bodyWidth <= 0))
 		return;
 
-	if (numberOfCols() == 0)
+	int texWidth = 0;
+	int texHeight = 0;
+	if (headerTexture)
+		SDL_QueryTexture(headerTexture, NULL, NULL, &texWidth, &texHeight);
+	if ((!headerTexture) || (texWidth != bodyWidth) || (texHeight != headerHeight))
+	{
+		if (headerTexture)
+			SDL_DestroyTexture(headerTexture);
+
+		headerTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+										  SDL_TEXTUREACCESS_TARGET, bodyWidth, headerHeight);
+		bodyDirty = true;
+	}
+
+	// still?
+	if (!headerTexture)
 		return;
 
-	// Draw the labels
-	unsigned int cIndex = scrollbar->getValue();
-	unsigned int maxRows = cIndex + rowsShown;
-	if (maxRows > numberOfRows())
-		maxRows = numberOfRows();
+	if (bodyDirty)
+	{
+		SDL_Texture* target = SDL_GetRenderTarget(renderer);
+		SDL_SetRenderTarget(renderer, headerTexture);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		SDL_SetTextureBlendMode(headerTexture, SDL_BLENDMODE_BLEND);
 
-	// Cell sizes
-	int cellHeight = height / rowsShown;
-	int cellWidth = width / numberOfCols();
-	if (scrollbar->isVisible())
-		cellWidth = (width - scrollbar->getWidth()) / numberOfCols();
+		for (unsigned int col = 0; col < headerLabels.size(); ++col)
+		{
+			std::string headerText = boundTable->getHeader(col);
+			if ((sortCol >= 0) && ((unsigned int)sortCol == col))
+				headerText += sortAscending ? " ^" : " v";
+
+			RULabel* cLabel = headerLabels[col];
+			cLabel->setText(headerText);
+
+			SDL_Rect cellRect;
+			cellRect.x = col * labelCellWidth;
+			cellRect.y = 0;
+			cellRect.w = labelCellWidth;
+			cellRect.h = headerHeight;
+			SDL_RenderSetViewport(renderer, &cellRect);
+
+			cLabel->drawText(renderer);
+			cLabel->updateBorderBackground(renderer);
+		}
+
+		SDL_RenderSetViewport(renderer, NULL);
+		SDL_SetRenderTarget(renderer, target);
+	}
+
+	SDL_Rect headerRect;
+	headerRect.x = 0;
+	headerRect.y = 0;
+	headerRect.w = bodyWidth;
+	headerRect.h = headerHeight;
+	SDL_RenderCopy(renderer, headerTexture, NULL, &headerRect);
+}
+
+/*!
+ * @brief draw the body
+ * @details shifts the rows already drawn by the distance scrolled since the last frame and only
+ * draws the rows it exposes. The whole body is drawn after a resize or a refresh.
+ * @param renderer the renderer to draw with
+ */
+void RUTable::drawBody(SDL_Renderer* renderer)
+{
+	if ((bodyWidth <= 0) || (bodyHeight <= 0))
+		return;
+
+	SDL_Texture* target = SDL_GetRenderTarget(renderer);
+
+	// (re)create the textures
+	int texWidth = 0;
+	int texHeight = 0;
+	if (bodyTexture)
+		SDL_QueryTexture(bodyTexture, NULL, NULL, &texWidth, &texHeight);
+	if ((!bodyTexture) || (!bodyScratch) || (texWidth != bodyWidth) || (texHeight != bodyHeight))
+	{
+		if (bodyTexture)
+			SDL_DestroyTexture(bodyTexture);
+		if (bodyScratch)
+			SDL_DestroyTexture(bodyScratch);
+
+		bodyTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+										SDL_TEXTUREACCESS_TARGET, bodyWidth, bodyHeight);
+		bodyScratch = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+										SDL_TEXTUREACCESS_TARGET, bodyWidth, bodyHeight);
+		bodyDirty = true;
+	}
+
+	// still?
+	if ((!bodyTexture) || (!bodyScratch))
+		return;
+
+	int shift = scrollY - drawnScrollY;
+	if ((!bodyDirty) && (shift == 0))
+		return;
 
-	// Only the visible labels
-	for (unsigned int row = 0; row < maxRows - cIndex; ++row)
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	if ((bodyDirty) || (shift >= bodyHeight) || (-shift >= bodyHeight))
 	{
-		for (unsigned int col = 0; col < numberOfCols(); ++col)
+		SDL_SetRenderTarget(renderer, bodyTexture);
+		SDL_RenderClear(renderer);
+		drawRows(renderer, 0, bodyHeight);
+	}
+	else
+	{
+		// copy the rows still in view into the scratch texture
+		SDL_Rect srcRect;
+		srcRect.x = 0;
+		srcRect.y = (shift > 0) ? shift : 0;
+		srcRect.w = bodyWidth;
+		srcRect.h = bodyHeight - ((shift > 0) ? shift : -shift);
+
+		SDL_Rect dstRect = srcRect;
+		dstRect.y = (shift > 0) ? 0 : -shift;
+
+		SDL_SetRenderTarget(renderer, bodyScratch);
+		SDL_RenderClear(renderer);
+		SDL_SetTextureBlendMode(bodyTexture, SDL_BLENDMODE_NONE);
+		SDL_RenderCopy(renderer, bodyTexture, &srcRect, &dstRect);
+
+		SDL_Texture* swapTexture = bodyTexture;
+		bodyTexture = bodyScratch;
+		bodyScratch = swapTexture;
+
+		// draw the exposed rows
+		if (shift > 0)
+			drawRows(renderer, bodyHeight - shift, bodyHeight);
+		else
+			drawRows(renderer, 0, -shift);
+	}
+
+	SDL_SetTextureBlendMode(bodyTexture, SDL_BLENDMODE_BLEND);
+	drawnScrollY = scrollY;
+	bodyDirty = false;
+
+	SDL_SetRenderTarget(renderer, target);
+}
+
+/*!
+ * @brief draw rows
+ * @details clears a strip of the body and draws the rows crossing it through the label pool
+ * @param renderer the renderer to draw with, targeting the body
+ * @param top the top of the strip
+ * @param bottom the bottom of the strip
+ */
+void RUTable::drawRows(SDL_Renderer* renderer, int top, int bottom)
+{
+	if ((labelCellHeight <= 0) || (top >= bottom))
+		return;
+
+	// clear the strip
+	SDL_Rect stripRect;
+	stripRect.x = 0;
+	stripRect.y = top;
+	stripRect.w = bodyWidth;
+	stripRect.h = bottom - top;
+	SDL_BlendMode prevBlendMode;
+	SDL_GetRenderDrawBlendMode(renderer, &prevBlendMode);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderFillRect(renderer, &stripRect);
+	SDL_SetRenderDrawBlendMode(renderer, prevBlendMode);
+
+	const unsigned int rowCount = getRowCount();
+	const unsigned int sourceCount = boundTable->numberOfRows();
+	if (rowCount == 0)
+		return;
+
+	unsigned int lastRow = (scrollY + bottom - 1) / labelCellHeight;
+	if (lastRow >= rowCount)
+		lastRow = rowCount - 1;
+
+	for (unsigned int row = (scrollY + top) / labelCellHeight; row <= lastRow; ++row)
+	{
+		// consecutive rows never share a pool row
+		std::vector<RULabel*>& labelRow = textLabels[row % textLabels.size()];
+		unsigned int sourceRow = getSourceRow(row);
+		if (sourceRow >= sourceCount)
+			continue;
+
+		for (unsigned int col = 0; col < labelRow.size(); ++col)
 		{
-			textLabels[row][col]->setMarginX(col * cellWidth);
-			textLabels[row][col]->setMarginY(row * cellHeight);
-			textLabels[row][col]->setWidth(cellWidth);
-			textLabels[row][col]->setHeight(cellHeight);
-			textLabels[row][col]->setFontSize(cellHeight / 2);
-			textLabels[row][col]->setText(getCell(row + cIndex, col).getString());
+			RULabel* cLabel = labelRow[col];
+			cLabel->setText(boundTable->getCell(sourceRow, col).getString());
+
+			SDL_Rect cellRect;
+			cellRect.x = col * labelCellWidth;
+			cellRect.y = (row * labelCellHeight) - scrollY;
+			cellRect.w = labelCellWidth;
+			cellRect.h = labelCellHeight;
+			SDL_RenderSetViewport(renderer, &cellRect);
+
+			cLabel->drawText(renderer);
+			cLabel->updateBorderBackground(renderer);
 		}
 	}
 
-	drawUpdate = true;
+	SDL_RenderSetViewport(renderer, NULL);
 }
 
 void RUTable::updateBackground(SDL_Renderer* renderer)
 {
-	//
+	if (textLabels.empty())
+		return;
+
+	layoutLabels();
+	if (labelCellHeight <= 0)
+		return;
+
+	// the scrollbar may have been dragged
+	if (firstRow != (unsigned int)scrollbar->getValue())
+	{
+		scrollVelocity = 0.0f;
+		setScrollY(scrollbar->getValue() * labelCellHeight);
+	}
+
+	// momentum from the wheel
+	if (scrollVelocity != 0.0f)
+	{
+		int oldScrollY = scrollY;
+		int step = (int)(scrollVelocity + ((scrollVelocity > 0.0f) ? 0.5f : -0.5f));
+		setScrollY(scrollY + step);
+		scrollVelocity = (scrollVelocity * SCROLL_FRICTION) / 100.0f;
+
+		// stopped or hit the end
+		if ((scrollY == oldScrollY) || ((scrollVelocity < 0.5f) && (scrollVelocity > -0.5f)))
+			scrollVelocity = 0.0f;
+		else
+			drawUpdate = true;
+	}
+
+	drawHeaders(renderer);
+	drawBody(renderer);
+
+	SDL_Rect bodyRect;
+	bodyRect.x = 0;
+	bodyRect.y = headerHeight;
+	bodyRect.w = bodyWidth;
+	bodyRect.h = bodyHeight;
+	if (bodyTexture)
+		SDL_RenderCopy(renderer, bodyTexture, NULL, &bodyRect);
 }
 
 /*!
  * @brief mouse down event handler
+ * @details sorts by the column of a clicked header, reversing the order on a second click
+ * @param cPanel the panel where the event occured
+ * @param eventX the x-coordinate of the click
+ * @param eventY the y-coordinate of the click
+ */
+void RUTable::onMouseDown(GPanel* cPanel, int eventX, int eventY)
+{
+	if ((eventY >= headerHeight) || (eventX >= bodyWidth) || (labelCellWidth <= 0))
+		return;
+
+	unsigned int col = eventX / labelCellWidth;
+	if (col >= headerLabels.size())
+		return;
+
+	if ((sortCol >= 0) && ((unsigned int)sortCol == col))
+		sortBy(col, !sortAscending);
+	else
+		sortBy(col);
+}
+
+/*!
+ * @brief mouse wheel event handler
  * @details responds to scrolls within the component. In this case, checks if the scroll happens
  * within the scrollbar and respond accordingly.
  * @param cPanel the panel where the event occured
@@ -300,20 +940,37 @@ void RUTable::onMouseWheel(GPanel* cPanel, int eventX, int eventY, int scrollTyp
 	// scrolling down on the labels
 	if (!(eventX >= scrollbar->getMarginX() && eventX < getWidth()))
 	{
-		int oldIndex = scrollbar->getValue();
+		// each notch carries the rows about one row as the velocity decays
+		float impulse = (labelCellHeight * (100 - SCROLL_FRICTION)) / 100.0f;
 		if (scrollType == SCROLL_DOWN)
-			scrollbar->decrement();
+			scrollVelocity -= impulse;
 		else if (scrollType == SCROLL_UP)
-			scrollbar->increment();
+			scrollVelocity += impulse;
 
-		if (oldIndex != scrollbar->getValue())
-		{
-			refreshLabels();
-			drawUpdate = true;
-		}
+		drawUpdate = true;
 	}
 }
 
+/*!
+ * @brief release textures
+ * @details frees the body and header textures too, the rows are drawn again when shown
+ */
+void RUTable::releaseTextures()
+{
+	if (bodyTexture)
+		SDL_DestroyTexture(bodyTexture);
+	bodyTexture = NULL;
+	if (bodyScratch)
+		SDL_DestroyTexture(bodyScratch);
+	bodyScratch = NULL;
+	if (headerTexture)
+		SDL_DestroyTexture(headerTexture);
+	headerTexture = NULL;
+	bodyDirty = true;
+
+	RUComponent::releaseTextures();
+}
+
 std::string RUTable::getType() const
 {
 	return "RUTable";
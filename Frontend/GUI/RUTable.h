@@ -18,7 +18,9 @@
 #define _RUTABLE
 
 #include "../../include/Backend/Database/gtable.h"
+#include "../GFXUtilities/RowIndex.h"
 #include "../GItems/RUComponent.h"
+#include <map>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
@@ -36,11 +38,52 @@ class RUTable : public RUComponent, public shmea::GTable
 	friend class RUDropdown;
 
 protected:
-	std::vector<std::vector<RULabel*> > textLabels; // size == visible(r, c)
+	// percent of the scroll velocity kept each frame
+	static const int SCROLL_FRICTION = 85;
+
+	std::vector<std::vector<RULabel*> > textLabels; // pool, size == (rowsShown + 1, cols)
 	RUScrollbar* scrollbar;
 	unsigned int rowsShown;
 
+	// the table the cells are read from, this one unless another is bound
+	const shmea::GTable* boundTable;
+	unsigned int firstRow;
+	int labelCellWidth;
+	int labelCellHeight;
+
+	// the rendered rows, shifted when scrolling so only the exposed rows are drawn
+	SDL_Texture* bodyTexture;
+	SDL_Texture* bodyScratch;
+	int bodyWidth;
+	int bodyHeight;
+	bool bodyDirty;
+	int scrollY;
+	int drawnScrollY;
+	float scrollVelocity;
+
+	// the view order over the table, used while sorted or filtered
+	RowIndex rowIndex;
+	bool indexed;
+	unsigned int indexedRows;
+	int sortCol;
+	bool sortAscending;
+	std::map<unsigned int, std::string> filters;
+
+	// click a header to sort by its column
+	std::vector<RULabel*> headerLabels;
+	SDL_Texture* headerTexture;
+	int headerHeight;
+
+	void resizeLabelPool(unsigned int, unsigned int, bool = false);
+	void layoutLabels();
+	void rebuildIndex();
+	void sortIndex();
+	void drawHeaders(SDL_Renderer*);
+	void drawBody(SDL_Renderer*);
+	void drawRows(SDL_Renderer*, int, int);
+
 	// events
+	virtual void onMouseDown(GPanel*, int, int);
 	virtual void onMouseWheel(GPanel*, int, int, int);
 
 public:
@@ -52,10 +95,24 @@ public:
 
 	// gets
 	unsigned int getRowsShown() const;
+	const shmea::GTable* getTable() const;
+	unsigned int getFirstRow() const;
+	int getScrollY() const;
+	unsigned int getRowCount() const;
+	unsigned int getSourceRow(unsigned int) const;
+	int getSortCol() const;
+	bool isSortAscending() const;
+	std::string getFilter(unsigned int) const;
 
 	// sets
 	void import(const shmea::GTable&);
+	void bind(const shmea::GTable*);
 	void setRowsShown(unsigned int);
+	void setScrollY(int);
+	void sortBy(unsigned int, bool = true);
+	void clearSort();
+	void setFilter(unsigned int, const std::string&);
+	void clearFilters();
 	void setWidth(int);
 	void setHeight(int);
 	void clear();
@@ -64,6 +121,7 @@ public:
 	void updateLabels();
 	void refreshLabels();
 	virtual void updateBackground(SDL_Renderer*);
+	virtual void releaseTextures();
 	virtual std::string getType() const;
 };
 
@@ -20,6 +20,7 @@
 #include "../GItems/GLayout.h"
 #include "../GItems/RUColors.h"
 #include "../GItems/RUComponent.h"
+#include "../GUI/RUTabContainer.h"
 #include "../GUI/Text/RULabel.h"
 #include "object.h"
 
@@ -540,6 +541,9 @@ void Graphics::display()
 		//=================Render=================
 		if (renderStatus == _2D)
 		{
+			// Free what hidden tabs hold
+			RUTabContainer::releaseAllHiddenTabs();
+
 			// Render the focused panel
 			if (focusedPanel)
 				focusedPanel->updateBackgroundHelper(renderer);
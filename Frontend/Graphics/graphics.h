@@ -52,6 +52,7 @@ class Graphics
 	friend class RUDropdown;
 	friend class RUKeyDown;
 	friend class RUKeyUp;
+	friend class GPanel;
 
 private:
 	static bool running;
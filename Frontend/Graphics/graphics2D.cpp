@@ -185,5 +185,6 @@ void Graphics::MsgBox(std::string title, std::string msg, int type)
 	newMsgBox->setX((focusedPanel->getWidth() / 2.0f) - (newMsgBox->getWidth() / 2.0f));
 	newMsgBox->setY((focusedPanel->getHeight() / 2.0f) - (newMsgBox->getHeight() / 2.0f));
 	newMsgBox->setName(title + ":" + msg);
-	focusedPanel->addSubItem(newMsgBox, GItem::Z_BACK);
+	newMsgBox->calculateSubItemPositions(std::pair<int, int>(0, 0));
+	focusedPanel->addOverlay(newMsgBox, true);
 }